@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "mkn/kul/alloc/base.hpp"
 #include "mkn/kul/alloc/aligned.hpp"
+#include "mkn/kul/alloc/arena.hpp"
 #include "mkn/kul/alloc/huge.hpp"  // active if available
 
 #endif /*MKN_KUL_ALLOC_HPP_*/
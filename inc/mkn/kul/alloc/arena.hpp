@@ -0,0 +1,101 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_ALLOC_ARENA_HPP_
+#define MKN_KUL_ALLOC_ARENA_HPP_
+
+#include "mkn/kul/defs.hpp"
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// bytes per Arena block unless a larger allocation needs more
+#ifndef MKN_KUL_ARENA_BLOCK
+#define MKN_KUL_ARENA_BLOCK (64 * 1024)
+#endif
+
+namespace mkn::kul {
+
+// Bump allocator over heap blocks, single allocations are never freed, reset() makes all of it
+//  reusable at once. Not thread safe, eg one per thread or per batch of work.
+class Arena {
+ public:
+  Arena(std::size_t const block = MKN_KUL_ARENA_BLOCK) : _block(block) {}
+
+  void* allocate(std::size_t const n, std::size_t const align = alignof(std::max_align_t)) {
+    if (auto* p = bump(n, align)) return p;
+    while (++_cur < _bs.size())
+      if (auto* p = (_at = 0, bump(n, align))) return p;
+    _bs.emplace_back((std::max)(n + align, _block));
+    _cur = _bs.size() - 1, _at = 0;
+    return bump(n, align);
+  }
+
+  // keeps every block for reuse
+  void reset() { _cur = 0, _at = 0; }
+
+  // bytes held in blocks
+  std::size_t capacity() const {
+    std::size_t c = 0;
+    for (auto const& b : _bs) c += b.n;
+    return c;
+  }
+
+ private:
+  struct Block {
+    Block(std::size_t const _n) : p(new unsigned char[_n]), n(_n) {}
+    std::unique_ptr<unsigned char[]> p;
+    std::size_t n;
+  };
+
+  void* bump(std::size_t const n, std::size_t const align) {
+    if (_cur >= _bs.size()) return nullptr;
+    auto const& b = _bs[_cur];
+    auto const base = reinterpret_cast<std::uintptr_t>(b.p.get());
+    auto const at = ((base + _at + align - 1) & ~(align - 1)) - base;
+    if (at + n > b.n) return nullptr;
+    _at = at + n;
+    return b.p.get() + at;
+  }
+
+  std::size_t const _block;
+  std::vector<Block> _bs;
+  std::size_t _cur = 0, _at = 0;
+
+  Arena(Arena const&) = delete;
+  Arena& operator=(Arena const&) = delete;
+};
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_ALLOC_ARENA_HPP_ */
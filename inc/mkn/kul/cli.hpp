@@ -245,16 +245,15 @@ class Args {
 namespace {
 std::size_t sub_string_to_next_occurrence(std::string const& cmd, std::size_t const s,
                                           std::string const& needle) {
-  std::string const rest = cmd.substr(s);
-  auto const pos = rest.find(needle);
+  auto const pos = cmd.find(needle, s);
   if (pos == std::string::npos)
     KEXCEPT(mkn::kul::Exception, "Error: CLI Arg parsing unclosed quotes!");
-  return pos + s;
+  return pos;
 }
 }  // namespace
 
 inline void asArgs(std::string const& cmd, std::vector<std::string>& args) {
-  std::string arg;
+  StringBuilder<> arg;
   bool openQuotesS = false, openQuotesD = false, backSlashed = false;
 
   for (std::size_t i = 0; i < cmd.size(); ++i) {
@@ -262,12 +261,12 @@ inline void asArgs(std::string const& cmd, std::vector<std::string>& args) {
 
     if (backSlashed) {
       backSlashed = false;
-      arg += c;
+      arg << c;
       continue;
 
     } else if (openQuotesD) {
       auto const pos = sub_string_to_next_occurrence(cmd, i, "\"");
-      arg += cmd.substr(i, pos - i);
+      arg << std::string_view(cmd).substr(i, pos - i);
       i = pos;
       openQuotesD = false;
       continue;
@@ -276,7 +275,7 @@ inline void asArgs(std::string const& cmd, std::vector<std::string>& args) {
     switch (c) {
       case ' ':
         if (!openQuotesD && !openQuotesS) {
-          if (arg.size() > 0) args.push_back(arg);
+          if (arg.size() > 0) args.emplace_back(arg.view());
           arg.clear();
           continue;
         }
@@ -284,7 +283,7 @@ inline void asArgs(std::string const& cmd, std::vector<std::string>& args) {
       case '"':
         if (openQuotesD && !openQuotesS) {
           openQuotesD = false;
-          args.push_back(arg);
+          args.emplace_back(arg.view());
           arg.clear();
         } else {
           openQuotesD = true;
@@ -293,7 +292,7 @@ inline void asArgs(std::string const& cmd, std::vector<std::string>& args) {
       case '\'':
         if (openQuotesS && !openQuotesD) {
           openQuotesS = false;
-          args.push_back(arg);
+          args.emplace_back(arg.view());
           arg.clear();
         } else {
           openQuotesS = true;
@@ -306,9 +305,9 @@ inline void asArgs(std::string const& cmd, std::vector<std::string>& args) {
         }
         break;
     }
-    arg += c;
+    arg << c;
   }
-  if (arg.size() > 0) args.push_back(arg);
+  if (arg.size() > 0) args.emplace_back(arg.view());
 }
 
 inline std::vector<std::string> asArgs(std::string const& cmd) {
@@ -107,6 +107,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MKN_KUL_DEBUG_DO_ELSE(...) __VA_ARGS__
 #endif
 
+// used to pad shared atomics apart, std::hardware_destructive_interference_size is not ABI stable
+#ifndef MKN_KUL_CACHE_LINE_SIZE
+#define MKN_KUL_CACHE_LINE_SIZE 64
+#endif
+
+// lock-free slots per thread queue, submissions past this fall back to a locked overflow queue
+#ifndef MKN_KUL_THREAD_QUEUE_SIZE
+#define MKN_KUL_THREAD_QUEUE_SIZE 1024
+#endif
+
 #include "mkn/kul/os/def.hpp"
 
 #endif /* MKN_KUL_DEFS_HPP */
@@ -0,0 +1,248 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_GRAPH_HPP_
+#define MKN_KUL_GRAPH_HPP_
+
+#include "mkn/kul/cpu.hpp"
+#include "mkn/kul/defs.hpp"
+#include "mkn/kul/except.hpp"
+#include "mkn/kul/threads.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <functional>
+
+namespace mkn::kul {
+namespace graph {
+
+class Exception : public mkn::kul::Exception {
+ public:
+  Exception(char const* f, uint16_t const& l, std::string const& s)
+      : mkn::kul::Exception(f, l, s) {}
+};
+
+struct Report {
+  std::vector<std::size_t> order;     // a valid serial execution order
+  std::vector<std::size_t> level;     // per task, length of the longest dependency chain before it
+  std::vector<std::size_t> critical;  // longest path by cost, first to last
+  double critical_cost = 0, total_cost = 0;
+  std::size_t width = 0;  // most tasks sharing one level, an upper bound on useful workers
+
+  // total_cost / critical_cost, the best possible speedup over serial execution
+  double parallelism() const { return critical_cost > 0 ? total_cost / critical_cost : 0; }
+};
+
+}  // namespace graph
+
+// Tasks with declared dependencies, run on a WorkStealingPool as soon as all their dependencies
+//  have finished. If a task throws, tasks not yet started are skipped and run() throws a
+//  graph::Exception naming the task, with the original exception as its cause()
+class TaskGraph {
+  struct Node {
+    std::string name;
+    std::function<void()> fn;
+    std::vector<std::size_t> deps, outs;
+    double cost = 1, took = 0;
+  };
+
+ public:
+  using Id = std::size_t;
+
+  // cost is only used by plan(), in any unit consistent across the graph
+  Id add(std::string const& name, std::function<void()>&& fn, std::vector<Id> const& deps = {},
+         double const cost = 1) {
+    auto const id = _n.size();
+    _n.emplace_back(Node{name, std::move(fn), {}, {}, cost, 0});
+    for (auto const d : deps) after(id, d);
+    return id;
+  }
+  // task runs only after dep has finished
+  TaskGraph& after(Id const task, Id const dep) {
+    if (task >= _n.size() || dep >= _n.size() || task == dep)
+      KEXCEPT(graph::Exception, "TaskGraph invalid dependency ", dep, " for task ", task);
+    _n[task].deps.emplace_back(dep);
+    _n[dep].outs.emplace_back(task);
+    return *this;
+  }
+
+  std::size_t size() const { return _n.size(); }
+  std::string const& name(Id const id) const { return _n.at(id).name; }
+  // seconds taken by the task during the last run()
+  double took(Id const id) const { return _n.at(id).took; }
+
+  // dry run, validates the graph without executing anything, throws graph::Exception on a cycle
+  //  measured uses durations from the last run() in place of the declared costs
+  graph::Report plan(bool const measured = false) const {
+    graph::Report r;
+    r.order = order();
+    r.level.resize(_n.size(), 0);
+    std::vector<double> finish(_n.size(), 0);
+    std::vector<std::size_t> prev(_n.size(), _n.size());
+    for (auto const i : r.order) {
+      double start = 0;
+      for (auto const d : _n[i].deps) {
+        r.level[i] = (std::max)(r.level[i], r.level[d] + 1);
+        if (finish[d] > start) start = finish[d], prev[i] = d;
+      }
+      auto const c = measured ? _n[i].took : _n[i].cost;
+      finish[i] = start + c;
+      r.total_cost += c;
+    }
+    std::vector<std::size_t> width;
+    for (auto const l : r.level) {
+      if (l >= width.size()) width.resize(l + 1, 0);
+      r.width = (std::max)(r.width, ++width[l]);
+    }
+    if (_n.empty()) return r;
+    auto last = std::max_element(finish.begin(), finish.end()) - finish.begin();
+    r.critical_cost = finish[last];
+    for (auto i = static_cast<std::size_t>(last); i < _n.size(); i = prev[i])
+      r.critical.emplace_back(i);
+    std::reverse(r.critical.begin(), r.critical.end());
+    return r;
+  }
+
+  // human readable plan, one line per task in execution order then the critical path
+  std::string str(bool const measured = false) const {
+    auto const r = plan(measured);
+    std::stringstream ss;
+    for (auto const i : r.order) {
+      ss << "[" << r.level[i] << "] " << _n[i].name << " (" << (measured ? _n[i].took : _n[i].cost)
+         << ")";
+      for (std::size_t d = 0; d < _n[i].deps.size(); ++d)
+        ss << (d ? ", " : " <- ") << _n[_n[i].deps[d]].name;
+      ss << std::endl;
+    }
+    ss << "critical path (" << r.critical_cost << " of " << r.total_cost << ", width "
+       << r.width << "):";
+    for (auto const i : r.critical) ss << " " << _n[i].name;
+    return ss.str();
+  }
+
+  // the calling thread helps the pool until every task has finished or been skipped
+  template <typename E>
+  void run(WorkStealingPool<E>& pool) KTHROW(graph::Exception) {
+    auto const r = order();  // throws on a cycle before anything runs
+    if (_n.empty()) return;
+    _left = std::make_unique<std::atomic<std::size_t>[]>(_n.size());
+    for (std::size_t i = 0; i < _n.size(); ++i) {
+      _left[i] = _n[i].deps.size();
+      _n[i].took = 0;
+    }
+    _done = 0;
+    _failed = 0;
+    _ep = nullptr;
+    for (auto const i : r)
+      if (_n[i].deps.empty()) post(pool, i);
+    while (_done.load(std::memory_order_acquire) < _n.size())
+      if (!pool.help()) std::this_thread::yield();
+    _left.reset();
+    if (_ep) std::rethrow_exception(_ep);
+  }
+  // on a temporary pool of the given size
+  void run(std::size_t const threads = cpu::threads()) KTHROW(graph::Exception) {
+    WorkStealingPool<> pool(std::max<std::size_t>(1, threads), 1);
+    run(pool);
+  }
+
+ private:
+  std::vector<Node> _n;
+  std::unique_ptr<std::atomic<std::size_t>[]> _left;
+  std::atomic<std::size_t> _done{0};
+  std::atomic<bool> _failed{0};
+  std::exception_ptr _ep;
+  std::mutex _ep_m;
+
+  // Kahn's algorithm, stable by insertion order
+  std::vector<Id> order() const {
+    std::vector<std::size_t> in(_n.size());
+    std::vector<Id> o;
+    o.reserve(_n.size());
+    for (std::size_t i = 0; i < _n.size(); ++i)
+      if (!(in[i] = _n[i].deps.size())) o.emplace_back(i);
+    for (std::size_t h = 0; h < o.size(); ++h)
+      for (auto const t : _n[o[h]].outs)
+        if (--in[t] == 0) o.emplace_back(t);
+    if (o.size() != _n.size())
+      for (std::size_t i = 0; i < _n.size(); ++i)
+        if (in[i]) KEXCEPT(graph::Exception, "TaskGraph cycle through task ", _n[i].name);
+    return o;
+  }
+
+  template <typename E>
+  void post(WorkStealingPool<E>& pool, Id const i) {
+    if (!pool.async([this, &pool, i]() { exec(pool, i); })) exec(pool, i);
+  }
+
+  template <typename E>
+  void exec(WorkStealingPool<E>& pool, Id const i) {
+    auto& n = _n[i];
+    if (!_failed.load(std::memory_order_relaxed)) {
+      auto const start = std::chrono::steady_clock::now();
+      try {
+        n.fn();
+      } catch (std::exception const& e) {
+        fail(n.name + ": " + e.what());
+      } catch (...) {
+        fail(n.name + ": unknown exception");
+      }
+      n.took = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    for (auto const t : n.outs)
+      if (_left[t].fetch_sub(1, std::memory_order_acq_rel) == 1) post(pool, t);
+    _done.fetch_add(1, std::memory_order_release);
+  }
+
+  // called from within a catch block so the graph::Exception keeps the original as its cause
+  void fail(std::string const& msg) {
+    std::lock_guard<std::mutex> l(_ep_m);
+    _failed = 1;
+    if (_ep) return;
+    try {
+      KEXCEPT(graph::Exception, "TaskGraph task failed - ", msg);
+    } catch (...) {
+      _ep = std::current_exception();
+    }
+  }
+};
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_GRAPH_HPP_ */
@@ -32,18 +32,37 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MKN_KUL_IO_HPP_
 
 #include <time.h>
+#include <cerrno>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <limits>
 #include <memory>
 #include <stdexcept>
+#include <streambuf>
+#include <vector>
+#include <initializer_list>
 
 #include "mkn/kul/except.hpp"
 #include "mkn/kul/log.hpp"
 #include "mkn/kul/os.hpp"
+#include "mkn/kul/span.hpp"
 #include "mkn/kul/string.hpp"
 
+#include <fcntl.h>
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+// BinaryWriter buffer bytes, writes at least this large skip the buffer
+#ifndef MKN_KUL_IO_WRITE_BUFFER
+#define MKN_KUL_IO_WRITE_BUFFER (1 << 16)
+#endif
+
 namespace mkn {
 namespace kul {
 namespace io {
@@ -64,6 +83,134 @@ inline std::streamoff checkedStreamOff(size_t const& l) KTHROW(Exception) {
   return static_cast<std::streamoff>(l);
 }
 
+// read or write n bytes at off without moving the file position, returns bytes moved or -errno
+inline std::int64_t positional(int const fd, bool const write, void* b, size_t const n,
+                               std::uint64_t const off) {
+#ifdef _WIN32
+  OVERLAPPED o{};
+  o.Offset = static_cast<DWORD>(off);
+  o.OffsetHigh = static_cast<DWORD>(off >> 32);
+  DWORD done = 0;
+  auto const h = reinterpret_cast<HANDLE>(::_get_osfhandle(fd));
+  auto const ok = write ? WriteFile(h, b, static_cast<DWORD>(n), &done, &o)
+                        : ReadFile(h, b, static_cast<DWORD>(n), &done, &o);
+  if (!ok && GetLastError() != ERROR_HANDLE_EOF) return -EIO;
+  return done;
+#else
+  for (;;) {
+    auto const r = write ? ::pwrite(fd, b, n, static_cast<off_t>(off))
+                         : ::pread(fd, b, n, static_cast<off_t>(off));
+    if (r < 0 && errno == EINTR) continue;
+    return r < 0 ? -errno : r;
+  }
+#endif
+}
+
+// stream buffer writing to a file descriptor through a buffer of the given size
+//  pending bytes and whole spans go out together as one gather write
+class FdBuf : public std::streambuf {
+ public:
+  FdBuf(int const fd, size_t const size) : _fd(fd), _buf(size ? size : 1) { reset(); }
+  ~FdBuf() { sync(); }
+
+  int fd() const { return _fd; }
+  // the fd is no longer written to, pending bytes are dropped and later writes fail
+  void detach() {
+    _fd = -1;
+    reset();
+  }
+  size_t pending() const { return static_cast<size_t>(pptr() - pbase()); }
+
+  // false on error, errno is left set
+  bool gather(Span<uint8_t const> const* spans, size_t const n) {
+    if (_fd < 0) {
+      errno = EBADF;
+      return false;
+    }
+#ifdef _WIN32
+    if (!flush()) return false;
+    for (size_t i = 0; i < n; ++i)
+      if (!put(reinterpret_cast<char const*>(spans[i].data()), spans[i].size())) return false;
+    return true;
+#else
+    constexpr size_t MAX = 1024;  // IOV_MAX on linux and the BSDs
+    std::vector<iovec> v;
+    v.reserve((n < MAX ? n : MAX) + 1);
+    if (pending()) v.push_back({pbase(), pending()});
+    for (size_t i = 0; i < n; ++i) {
+      if (spans[i].size() == 0) continue;
+      v.push_back({const_cast<uint8_t*>(spans[i].data()), spans[i].size()});
+      if (v.size() == MAX && !writev(v)) return false;
+    }
+    if (!writev(v)) return false;
+    reset();
+    return true;
+#endif
+  }
+
+ protected:
+  int_type overflow(int_type const c) override {
+    if (!flush()) return traits_type::eof();
+    if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+    return c;
+  }
+  int sync() override { return flush() ? 0 : -1; }
+  std::streamsize xsputn(char const* s, std::streamsize const n) override {
+    if (static_cast<size_t>(n) < _buf.size()) return std::streambuf::xsputn(s, n);
+    Span<uint8_t const> const span(reinterpret_cast<uint8_t const*>(s), static_cast<size_t>(n));
+    return gather(&span, 1) ? n : 0;
+  }
+
+ private:
+  int _fd;
+  std::vector<char> _buf;
+
+  void reset() { setp(_buf.data(), _buf.data() + _buf.size()); }
+  bool flush() {
+    if (!put(pbase(), pending())) return false;
+    reset();
+    return true;
+  }
+  bool put(char const* c, size_t n) {
+    if (_fd < 0 && n) {
+      errno = EBADF;
+      return false;
+    }
+    while (n) {
+#ifdef _WIN32
+      auto const w = ::_write(_fd, c, static_cast<unsigned>(n));
+#else
+      auto const w = ::write(_fd, c, n);
+      if (w < 0 && errno == EINTR) continue;
+#endif
+      if (w <= 0) return false;
+      c += w;
+      n -= static_cast<size_t>(w);
+    }
+    return true;
+  }
+#ifndef _WIN32
+  // v is consumed, short writes resume mid vector
+  bool writev(std::vector<iovec>& v) {
+    size_t i = 0;
+    while (i < v.size()) {
+      auto w = ::writev(_fd, &v[i], static_cast<int>(v.size() - i));
+      if (w < 0 && errno == EINTR) continue;
+      if (w <= 0) return false;
+      for (; i < v.size() && static_cast<size_t>(w) >= v[i].iov_len; ++i) w -= v[i].iov_len;
+      if (i < v.size()) {
+        v[i].iov_base = static_cast<char*>(v[i].iov_base) + w;
+        v[i].iov_len -= static_cast<size_t>(w);
+      }
+    }
+    v.clear();
+    return true;
+  }
+#endif
+};
+
 class AReader {
  public:
   std::ifstream const& buffer() const { return f; }
@@ -218,20 +365,104 @@ class Writer : public AWriter {
   Writer(File const& c, bool a = 0) : Writer(c.full().c_str(), a) {}
   ~Writer() {}
 };
+// AWriter over a raw file descriptor rather than a filebuf, adding gather writes, positional
+//  writes and preallocation. Stream and write calls are buffered in FdBuf.
 class BinaryWriter : public AWriter {
  public:
-  BinaryWriter(char const* c) {
-    f.open(c, std::ios::out | std::ios::binary);
-    if (!f) KEXCEPT(Exception, "FileException : file \"" + std::string(c) + "\" not found");
+  BinaryWriter(char const* c, size_t const buffer = MKN_KUL_IO_WRITE_BUFFER)
+      : _b(open(c), buffer) {
+    f.std::ostream::rdbuf(&_b);
     f.unsetf(std::ios_base::skipws);
   }
-  BinaryWriter(File const& c) : BinaryWriter(c.full().c_str()) {}
+  BinaryWriter(File const& c, size_t const buffer = MKN_KUL_IO_WRITE_BUFFER)
+      : BinaryWriter(c.full().c_str(), buffer) {}
   ~BinaryWriter() {
     f << std::flush;
-    f.close();
+    f.std::ostream::rdbuf(nullptr);
+    close();
+  }
+
+  // -1 once closed
+  int fd() const { return _b.fd(); }
+
+  // buffered bytes then every span with as few writev calls as possible
+  BinaryWriter& write(std::initializer_list<Span<uint8_t const>> const spans) KTHROW(Exception) {
+    return write(spans.begin(), spans.size());
+  }
+  BinaryWriter& write(std::vector<Span<uint8_t const>> const& spans) KTHROW(Exception) {
+    return write(spans.data(), spans.size());
+  }
+  using AWriter::write;
+
+  // at off regardless of the stream position and without flushing, safe from many threads
+  //  at once, eg into a file sized with allocate
+  BinaryWriter& pwrite(Span<uint8_t const> const& s, std::uint64_t off) KTHROW(Exception) {
+    auto* b = const_cast<uint8_t*>(s.data());
+    for (size_t n = s.size(); n;) {
+      auto const w = positional(live(), true, b, n, off);
+      if (w <= 0) KEXCEPT(Exception, "BinaryWriter pwrite failed: " + err(w));
+      b += w, off += static_cast<std::uint64_t>(w), n -= static_cast<size_t>(w);
+    }
+    return *this;
+  }
+
+  // reserves disk blocks so later positional writes cannot fail for space
+  BinaryWriter& allocate(std::uint64_t const bytes) KTHROW(Exception) {
+    auto const fd = live();
+#if defined(_WIN32)
+    auto const r = ::_chsize_s(fd, static_cast<__int64>(bytes)) ? -errno : 0;
+#elif defined(__linux__)
+    auto const r = -::posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+#else
+    auto const r = ::ftruncate(fd, static_cast<off_t>(bytes)) ? -errno : 0;
+#endif
+    if (r) KEXCEPT(Exception, "BinaryWriter allocate failed: " + err(r));
+    return *this;
+  }
+
+  void close() {
+    if (_fd < 0) return;
+    f << std::flush;
+    _b.detach();
+#ifdef _WIN32
+    ::_close(_fd);
+#else
+    ::close(_fd);
+#endif
+    _fd = -1;
+  }
+
+ private:
+  int _fd = -1;
+  FdBuf _b;
+
+  int open(char const* c) KTHROW(Exception) {
+#ifdef _WIN32
+    _fd = ::_open(c, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    _fd = ::open(c, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+    if (_fd < 0) KEXCEPT(Exception, "FileException : file \"" + std::string(c) + "\" not found");
+    return _fd;
+  }
+  int live() const KTHROW(Exception) {
+    if (_fd < 0) KEXCEPT(Exception, "BinaryWriter is closed");
+    return _fd;
+  }
+  static std::string err(std::int64_t const e) { return std::strerror(static_cast<int>(-e)); }
+
+  BinaryWriter& write(Span<uint8_t const> const* spans, size_t const n) KTHROW(Exception) {
+    live();
+    if (!_b.gather(spans, n))
+      KEXCEPT(Exception, "BinaryWriter write failed: " + std::string(std::strerror(errno)));
+    return *this;
   }
 };
 }  // namespace io
 }  // namespace kul
 }  // namespace mkn
+
+#include "mkn/kul/io/map.hpp"
+#include "mkn/kul/io/line.hpp"
+
 #endif /* MKN_KUL_IO_HPP_ */
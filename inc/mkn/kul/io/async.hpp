@@ -0,0 +1,432 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_IO_ASYNC_HPP_
+#define MKN_KUL_IO_ASYNC_HPP_
+
+#include "mkn/kul/io.hpp"
+#include "mkn/kul/threads.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include <fcntl.h>
+#if MKN_KUL_IS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if MKN_KUL_IS_NIX && __has_include(<linux/io_uring.h>) && !defined(MKN_KUL_IO_NO_URING)
+#include <linux/io_uring.h>
+#endif
+// headers from 5.6 on, the first with IORING_OP_READ/WRITE and IORING_REGISTER_PROBE
+#if defined(IO_URING_OP_SUPPORTED)
+#define MKN_KUL_IO_URING 1
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#else
+#define MKN_KUL_IO_URING 0
+#endif
+
+// operations an AsyncFile keeps in flight before a new one waits for a completion
+#ifndef MKN_KUL_IO_ASYNC_DEPTH
+#define MKN_KUL_IO_ASYNC_DEPTH 64
+#endif
+
+// threads serving an AsyncFile when io_uring is not available
+#ifndef MKN_KUL_IO_ASYNC_THREADS
+#define MKN_KUL_IO_ASYNC_THREADS 4
+#endif
+
+namespace mkn::kul::io {
+namespace async {
+
+enum class Access : std::uint8_t { READ, WRITE, READ_WRITE };
+enum class Backend : std::uint8_t { AUTO, URING, THREADS };
+
+struct Buffer {
+  void* data;
+  std::size_t size;
+};
+
+#if MKN_KUL_IO_URING
+// minimal io_uring over the raw system calls, the SQ and CQ are shared memory rings with the
+//  kernel. Single threaded, the owning AsyncFile serialises access.
+class Ring {
+ public:
+  static std::unique_ptr<Ring> make(unsigned const entries) {
+    std::unique_ptr<Ring> r(new Ring);
+    io_uring_params p;
+    std::memset(&p, 0, sizeof(p));
+    r->fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+    if (r->fd < 0 || !(p.features & IORING_FEAT_SINGLE_MMAP) || !r->probe()) return nullptr;
+    r->ring_sz = std::max(p.sq_off.array + p.sq_entries * sizeof(unsigned),
+                          p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe));
+    r->ring = ::mmap(nullptr, r->ring_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     r->fd, IORING_OFF_SQ_RING);
+    if (r->ring == MAP_FAILED) {
+      r->ring = nullptr;
+      return nullptr;
+    }
+    r->sqes_sz = p.sq_entries * sizeof(io_uring_sqe);
+    auto* const s = ::mmap(nullptr, r->sqes_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           r->fd, IORING_OFF_SQES);
+    if (s == MAP_FAILED) return nullptr;
+    r->sqes = static_cast<io_uring_sqe*>(s);
+    auto* const b = static_cast<char*>(r->ring);
+    r->sq_head = reinterpret_cast<unsigned*>(b + p.sq_off.head);
+    r->sq_tail = reinterpret_cast<unsigned*>(b + p.sq_off.tail);
+    r->sq_mask = *reinterpret_cast<unsigned*>(b + p.sq_off.ring_mask);
+    r->sq_array = reinterpret_cast<unsigned*>(b + p.sq_off.array);
+    r->cq_head = reinterpret_cast<unsigned*>(b + p.cq_off.head);
+    r->cq_tail = reinterpret_cast<unsigned*>(b + p.cq_off.tail);
+    r->cq_mask = *reinterpret_cast<unsigned*>(b + p.cq_off.ring_mask);
+    r->cqes = reinterpret_cast<io_uring_cqe*>(b + p.cq_off.cqes);
+    r->entries = p.sq_entries;
+    return r;
+  }
+  ~Ring() {
+    if (sqes) ::munmap(sqes, sqes_sz);
+    if (ring) ::munmap(ring, ring_sz);
+    if (fd >= 0) ::close(fd);
+  }
+
+  // a zeroed entry queued behind those not yet submitted, nullptr if the SQ is full
+  io_uring_sqe* sqe() {
+    auto const head = std::atomic_ref<unsigned>(*sq_head).load(std::memory_order_acquire);
+    if (tail - head >= entries) return nullptr;
+    auto const i = tail++ & sq_mask;
+    sq_array[i] = i;
+    std::memset(&sqes[i], 0, sizeof(io_uring_sqe));
+    return &sqes[i];
+  }
+  // publishes queued entries and optionally waits for wait completions, returns -errno on error
+  int enter(unsigned const wait) {
+    std::atomic_ref<unsigned>(*sq_tail).store(tail, std::memory_order_release);
+    auto const n = tail - submitted;
+    for (;;) {
+      auto const r = ::syscall(__NR_io_uring_enter, fd, n, wait, wait ? IORING_ENTER_GETEVENTS : 0,
+                               nullptr, 0);
+      if (r < 0 && errno == EINTR) continue;
+      if (r < 0) return -errno;
+      submitted += static_cast<unsigned>(r);
+      return static_cast<int>(r);
+    }
+  }
+  // f(user_data, res) for every completion available, returns the count
+  template <typename F>
+  std::size_t reap(F&& f) {
+    auto head = *cq_head;
+    auto const end = std::atomic_ref<unsigned>(*cq_tail).load(std::memory_order_acquire);
+    std::size_t c = 0;
+    for (; head != end; ++head, ++c) {
+      auto const& e = cqes[head & cq_mask];
+      f(e.user_data, e.res);
+    }
+    std::atomic_ref<unsigned>(*cq_head).store(head, std::memory_order_release);
+    return c;
+  }
+  bool registerBuffers(std::vector<Buffer> const& bs) {
+    std::vector<iovec> v(bs.size());
+    for (std::size_t i = 0; i < bs.size(); ++i) v[i] = {bs[i].data, bs[i].size};
+    ::syscall(__NR_io_uring_register, fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+    return bs.empty() || ::syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, v.data(),
+                                   static_cast<unsigned>(v.size())) == 0;
+  }
+  bool pending() const { return tail != submitted; }
+
+ private:
+  int fd = -1;
+  void* ring = nullptr;
+  std::size_t ring_sz = 0, sqes_sz = 0;
+  io_uring_sqe* sqes = nullptr;
+  io_uring_cqe* cqes = nullptr;
+  unsigned *sq_head = nullptr, *sq_tail = nullptr, *sq_array = nullptr;
+  unsigned *cq_head = nullptr, *cq_tail = nullptr;
+  unsigned sq_mask = 0, cq_mask = 0, entries = 0, tail = 0, submitted = 0;
+
+  Ring() = default;
+
+  // every opcode AsyncFile submits, older kernels fail them all with -EINVAL
+  bool probe() const {
+    constexpr unsigned N = IORING_OP_WRITE + 1;
+    std::vector<char> b(sizeof(io_uring_probe) + N * sizeof(io_uring_probe_op), 0);
+    auto* const p = reinterpret_cast<io_uring_probe*>(b.data());
+    if (::syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, p, N) != 0) return false;
+    return std::all_of(std::begin(OPS), std::end(OPS), [&](auto const op) {
+      return op <= p->last_op && (p->ops[op].flags & IO_URING_OP_SUPPORTED);
+    });
+  }
+  static constexpr std::uint8_t OPS[] = {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED,
+                                         IORING_OP_WRITE_FIXED};
+};
+#endif  // MKN_KUL_IO_URING
+
+}  // namespace async
+
+// Positional reads and writes kept in flight together, completing out of order.
+//  read/write only queue an operation, submit() hands every queued one over in one batch and
+//  poll/wait/drain run the callbacks of those complete, always on the calling thread.
+//  io_uring is used on Linux where the kernel allows it, otherwise a pool of threads does
+//  pread/pwrite. Not thread safe, buffers must outlive their operation.
+class AsyncFile {
+  using Backend = async::Backend;
+
+ public:
+  using Callback = std::function<void(std::int64_t)>;  // bytes transferred, or -errno
+
+  AsyncFile(char const* const path, async::Access const access = async::Access::READ,
+            unsigned const depth = MKN_KUL_IO_ASYNC_DEPTH, Backend const backend = Backend::AUTO)
+      KTHROW(Exception)
+      : _depth(depth ? depth : 1), _ops(_depth) {
+    int const flags = access == async::Access::READ    ? O_RDONLY
+                      : access == async::Access::WRITE ? O_WRONLY | O_CREAT
+                                                       : O_RDWR | O_CREAT;
+#if MKN_KUL_IS_WIN
+    _fd = ::_open(path, flags | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    _fd = ::open(path, flags | O_CLOEXEC, 0644);
+#endif
+    if (_fd < 0) KEXCEPT(Exception, "FileException : file \"" + std::string(path) + "\" not found");
+    for (unsigned i = _depth; i-- > 0;) _free.emplace_back(i);
+#if MKN_KUL_IO_URING
+    if (backend != Backend::THREADS) _ring = async::Ring::make(_depth);
+#endif
+    if (backend == Backend::URING && !uring()) {
+      close();
+      KEXCEPT(Exception, "io_uring is not available");
+    }
+    if (!uring())
+      _pool = std::make_unique<WorkStealingPool<>>(MKN_KUL_IO_ASYNC_THREADS, 1);
+  }
+  AsyncFile(File const& f, async::Access const access = async::Access::READ,
+            unsigned const depth = MKN_KUL_IO_ASYNC_DEPTH, Backend const backend = Backend::AUTO)
+      : AsyncFile(f.full().c_str(), access, depth, backend) {}
+  ~AsyncFile() {
+    try {
+      drain();
+    } catch (...) {  // callbacks are not run from here on
+    }
+    _pool.reset();
+#if MKN_KUL_IO_URING
+    _ring.reset();
+#endif
+    close();
+  }
+
+  bool uring() const {
+#if MKN_KUL_IO_URING
+    return bool(_ring);
+#else
+    return false;
+#endif
+  }
+  int fd() const { return _fd; }
+  std::size_t inflight() const { return _depth - _free.size(); }
+
+  // reads or writes through these use registered buffers under io_uring, saving the kernel
+  //  mapping the pages for each operation, replaces any registered before
+  void buffers(std::vector<async::Buffer> bs) KTHROW(Exception) {
+    drain();
+#if MKN_KUL_IO_URING
+    if (_ring && !_ring->registerBuffers(bs))
+      KEXCEPT(Exception, "io_uring buffer registration failed");
+#endif
+    _buffers = std::move(bs);
+  }
+
+  // waits for a completion, running its callback, if depth operations are already in flight
+  void read(void* const b, std::size_t const n, std::uint64_t const off, Callback cb) {
+    queue(false, b, n, off, std::move(cb));
+  }
+  void write(void const* const b, std::size_t const n, std::uint64_t const off, Callback cb) {
+    queue(true, const_cast<void*>(b), n, off, std::move(cb));
+  }
+
+  // hands every queued operation over, returns how many
+  std::size_t submit() KTHROW(Exception) {
+    std::size_t n = 0;
+#if MKN_KUL_IO_URING
+    if (_ring) {
+      while (_ring->pending()) {
+        auto const r = _ring->enter(0);
+        if (r < 0) KEXCEPT(Exception, "io_uring_enter failed: " + std::string(std::strerror(-r)));
+        n += static_cast<std::size_t>(r);
+      }
+      return n;
+    }
+#endif
+    for (auto const i : _queued) {
+      auto& op = _ops[i];
+      std::function<void()> job = [this, i, fd = _fd, w = op.write, b = op.b, s = op.n,
+                                   o = op.off]() {
+        auto const r = positional(fd, w, b, s, o);
+        {
+          std::lock_guard<std::mutex> l(_m);
+          _done.emplace_back(i, r);
+        }
+        _cv.notify_one();
+      };
+      if (!_pool->async(std::move(job))) job();
+      ++n;
+    }
+    _queued.clear();
+    return n;
+  }
+
+  // runs the callbacks of operations already complete, returns how many
+  std::size_t poll() { return reap(false); }
+  // submits, then waits until at least one operation completes unless none are in flight
+  std::size_t wait() {
+    submit();
+    return inflight() ? reap(true) : 0;
+  }
+  // submits, then waits for every operation in flight
+  void drain() {
+    while (inflight()) wait();
+  }
+
+ private:
+  struct Op {
+    bool write = false;
+    void* b = nullptr;
+    std::size_t n = 0;
+    std::uint64_t off = 0;
+    Callback cb;
+  };
+
+  int _fd = -1;
+  unsigned const _depth;
+  std::vector<Op> _ops;
+  std::vector<unsigned> _free, _queued;
+  std::vector<async::Buffer> _buffers;
+#if MKN_KUL_IO_URING
+  std::unique_ptr<async::Ring> _ring;
+#endif
+  std::unique_ptr<WorkStealingPool<>> _pool;
+  std::mutex _m;  // guards _done
+  std::condition_variable _cv;
+  std::vector<std::pair<unsigned, std::int64_t>> _done;
+
+  void close() {
+    if (_fd < 0) return;
+#if MKN_KUL_IS_WIN
+    ::_close(_fd);
+#else
+    ::close(_fd);
+#endif
+    _fd = -1;
+  }
+
+  void queue(bool const write, void* const b, std::size_t const n, std::uint64_t const off,
+             Callback&& cb) {
+    while (_free.empty()) wait();
+    auto const i = _free.back();
+    _free.pop_back();
+    _ops[i] = Op{write, b, n, off, std::move(cb)};
+#if MKN_KUL_IO_URING
+    if (_ring) {
+      auto* e = _ring->sqe();
+      if (!e) {  // cannot happen while inflight <= depth, but the kernel may round entries down
+        submit();
+        while (!(e = _ring->sqe())) reap(true);
+      }
+      e->fd = _fd;
+      e->off = off;
+      e->addr = reinterpret_cast<std::uint64_t>(b);
+      e->len = static_cast<std::uint32_t>(n);
+      e->opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+      e->user_data = i;
+      auto const* const c = static_cast<char const*>(b);
+      for (std::size_t bi = 0; bi < _buffers.size(); ++bi) {
+        auto const* const rb = static_cast<char const*>(_buffers[bi].data);
+        if (c >= rb && c + n <= rb + _buffers[bi].size) {
+          e->opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+          e->buf_index = static_cast<std::uint16_t>(bi);
+          break;
+        }
+      }
+      return;
+    }
+#endif
+    _queued.emplace_back(i);
+  }
+
+  // callbacks may queue more operations, so completions are collected before any is run
+  std::size_t reap(bool const block) {
+    std::vector<std::pair<unsigned, std::int64_t>> got;
+#if MKN_KUL_IO_URING
+    if (_ring) {
+      if (block && !_ring->reap([&](std::uint64_t const u, std::int32_t const r) {
+            got.emplace_back(static_cast<unsigned>(u), r);
+          })) {
+        auto const r = _ring->enter(1);
+        if (r < 0 && r != -EINTR)
+          KEXCEPT(Exception, "io_uring_enter failed: " + std::string(std::strerror(-r)));
+      }
+      _ring->reap([&](std::uint64_t const u, std::int32_t const r) {
+        got.emplace_back(static_cast<unsigned>(u), r);
+      });
+    } else
+#endif
+    {
+      std::unique_lock<std::mutex> l(_m);
+      if (block) _cv.wait(l, [&]() { return !_done.empty(); });
+      got.swap(_done);
+    }
+    for (auto const& [i, r] : got) {
+      auto cb = std::move(_ops[i].cb);
+      _ops[i] = Op{};
+      _free.emplace_back(i);
+      if (cb) cb(r);
+    }
+    return got.size();
+  }
+
+  AsyncFile(AsyncFile const&) = delete;
+  AsyncFile(AsyncFile&&) = delete;
+  AsyncFile& operator=(AsyncFile const&) = delete;
+  AsyncFile& operator=(AsyncFile&&) = delete;
+};
+
+}  // namespace mkn::kul::io
+
+#endif /* MKN_KUL_IO_ASYNC_HPP_ */
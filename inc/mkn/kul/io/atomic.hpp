@@ -0,0 +1,228 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_IO_ATOMIC_HPP_
+#define MKN_KUL_IO_ATOMIC_HPP_
+
+#include "mkn/kul/io.hpp"
+#include "mkn/kul/proc.hpp"
+#include "mkn/kul/parallel.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include <fcntl.h>
+#if MKN_KUL_IS_WIN
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+namespace mkn::kul::io {
+
+class AtomicBatch;
+
+// BinaryWriter onto a temp file beside the target, which commit renames over the target
+//  so readers see either the old or the whole new file. With sync the data is on disk before
+//  the rename and the rename is on disk before commit returns. Uncommitted temp files are
+//  removed by the destructor.
+class AtomicWriter : public BinaryWriter {
+  friend class AtomicBatch;
+
+ public:
+  AtomicWriter(char const* target, bool const sync = true,
+               size_t const buffer = MKN_KUL_IO_WRITE_BUFFER)
+      : AtomicWriter(std::string(target), TEMP(target), sync, buffer) {}
+  AtomicWriter(File const& target, bool const sync = true,
+               size_t const buffer = MKN_KUL_IO_WRITE_BUFFER)
+      : AtomicWriter(target.full().c_str(), sync, buffer) {}
+  ~AtomicWriter() {
+    if (!_done) discard();
+  }
+
+  void commit() KTHROW(Exception) {
+    if (_done) KEXCEPT(Exception, "AtomicWriter already committed or discarded: " + _target);
+    data();
+    rename();
+    if (_sync) DIR_SYNC(DIR(_target));
+  }
+  // drops everything written, the target is left untouched
+  void discard() {
+    _done = true;
+    close();
+    std::remove(_temp.c_str());
+  }
+
+  std::string const& target() const { return _target; }
+  std::string const& temp() const { return _temp; }
+
+ private:
+  AtomicWriter(std::string&& target, std::string&& temp, bool const sync, size_t const buffer)
+      : BinaryWriter(temp.c_str(), buffer),
+        _sync(sync),
+        _target(std::move(target)),
+        _temp(std::move(temp)) {}
+
+  // .<name>.<pid>.<n>.tmp in the target's directory, rename is only atomic within a file system
+  static std::string TEMP(std::string const& target) {
+    static std::atomic<std::uint64_t> n{0};
+    auto const p = SPLIT(target);
+    return target.substr(0, p) + "." + target.substr(p) + "." +
+           std::to_string(mkn::kul::this_proc::id()) + "." + std::to_string(n++) + ".tmp";
+  }
+  static size_t SPLIT(std::string const& s) {
+#if MKN_KUL_IS_WIN
+    auto const p = s.find_last_of("\\/");
+#else
+    auto const p = s.rfind('/');
+#endif
+    return p == std::string::npos ? 0 : p + 1;
+  }
+  static std::string DIR(std::string const& s) {
+    auto const p = SPLIT(s);
+    return p == 0 ? "." : p == 1 ? s.substr(0, 1) : s.substr(0, p - 1);
+  }
+  // the directory entry of a rename is only durable once the directory itself is synced,
+  //  Windows has no equivalent and relies on MOVEFILE_WRITE_THROUGH
+  static void DIR_SYNC(std::string const& d) KTHROW(Exception) {
+#if !MKN_KUL_IS_WIN
+    auto const fd = ::open(d.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) KEXCEPT(Exception, "AtomicWriter cannot open directory: " + d);
+    auto const r = ::fsync(fd);
+    ::close(fd);
+    if (r) KEXCEPT(Exception, "AtomicWriter directory sync failed: " + d);
+#else
+    (void)d;
+#endif
+  }
+
+  // a replaced target keeps its permission bits, eg a script stays executable
+  //  true if the temp file's mode was changed, Windows attributes are not carried over
+  bool mode() KTHROW(Exception) {
+#if !MKN_KUL_IS_WIN
+    struct stat st;
+    if (::stat(_target.c_str(), &st)) return false;
+    if (::fchmod(fd(), st.st_mode & 07777)) fail("chmod failed");
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // flushes, syncs if asked and closes the temp file
+  void data() KTHROW(Exception) {
+    if (_done) return;
+    flush();
+    if (!f) fail("write failed");
+    [[maybe_unused]] auto const meta = mode();
+    if (_sync) {
+#if MKN_KUL_IS_WIN
+      auto const r = ::_commit(fd());
+#elif MKN_KUL_IS_BSD
+      auto const r = ::fsync(fd());
+#else
+      auto const r = meta ? ::fsync(fd()) : ::fdatasync(fd());  // the mode is metadata too
+#endif
+      if (r) fail("sync failed");
+    }
+    close();
+  }
+  void rename() KTHROW(Exception) {
+#if MKN_KUL_IS_WIN
+    auto const ok = MoveFileExA(_temp.c_str(), _target.c_str(),
+                                MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    auto const ok = ::rename(_temp.c_str(), _target.c_str()) == 0;
+#endif
+    if (!ok) fail("rename failed");
+    _done = true;
+  }
+  void fail(std::string const& what) KTHROW(Exception) {
+    auto const e = std::string(std::strerror(errno));
+    discard();
+    KEXCEPT(Exception, "AtomicWriter " + what + " for \"" + _target + "\": " + e);
+  }
+
+  bool _done = false;
+  bool const _sync;
+  std::string const _target, _temp;
+};
+
+// Group commit of many AtomicWriters, the data syncs run in parallel on the shared pool then
+//  every rename is made and each distinct directory is synced once. A failure discards what
+//  has not yet been renamed, files already renamed stay replaced.
+class AtomicBatch {
+ public:
+  AtomicBatch(bool const sync = true) : _sync(sync) {}
+
+  AtomicWriter& add(char const* target, size_t const buffer = MKN_KUL_IO_WRITE_BUFFER) {
+    return *_ws.emplace_back(std::make_unique<AtomicWriter>(target, _sync, buffer));
+  }
+  AtomicWriter& add(File const& target, size_t const buffer = MKN_KUL_IO_WRITE_BUFFER) {
+    return add(target.full().c_str(), buffer);
+  }
+
+  void commit() KTHROW(Exception) {
+    try {
+      parallel::run(parallel::pool(), _ws.size(), [&](std::size_t const i) { _ws[i]->data(); });
+      std::vector<std::string> dirs;
+      for (auto& w : _ws) {
+        w->rename();
+        if (_sync) dirs.emplace_back(AtomicWriter::DIR(w->target()));
+      }
+      std::sort(dirs.begin(), dirs.end());
+      dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+      for (auto const& d : dirs) AtomicWriter::DIR_SYNC(d);
+    } catch (...) {
+      _ws.clear();
+      throw;
+    }
+    _ws.clear();
+  }
+  void discard() { _ws.clear(); }
+
+  size_t size() const { return _ws.size(); }
+
+ private:
+  bool const _sync;
+  std::vector<std::unique_ptr<AtomicWriter>> _ws;
+};
+
+}  // namespace mkn::kul::io
+
+#endif /* MKN_KUL_IO_ATOMIC_HPP_ */
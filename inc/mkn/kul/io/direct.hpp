@@ -0,0 +1,329 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_IO_DIRECT_HPP_
+#define MKN_KUL_IO_DIRECT_HPP_
+
+#include "mkn/kul/io.hpp"
+#include "mkn/kul/span.hpp"
+#include "mkn/kul/alloc/aligned.hpp"
+
+#include <mutex>
+#include <array>
+#include <cerrno>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <condition_variable>
+
+#include <fcntl.h>
+#if MKN_KUL_IS_WIN
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// bytes per DirectReader/DirectWriter buffer, rounded up to io::direct::ALIGN, two are used
+#ifndef MKN_KUL_IO_DIRECT_BLOCK
+#define MKN_KUL_IO_DIRECT_BLOCK (1 << 20)
+#endif
+
+namespace mkn::kul::io {
+namespace direct {
+
+// buffer addresses, sizes and file offsets are multiples of this
+constexpr std::size_t ALIGN = 4096;
+using Buffer = std::vector<std::uint8_t, AlignedAllocator<std::uint8_t, ALIGN>>;
+
+inline std::size_t round(std::size_t const n) { return (n ? (n + ALIGN - 1) / ALIGN : 1) * ALIGN; }
+
+// opens bypassing the page cache, is_direct is false where the file system refuses that, eg tmpfs
+inline int open(char const* const path, bool const write, bool& is_direct) KTHROW(Exception) {
+  is_direct = false;
+  int fd = -1;
+#if MKN_KUL_IS_WIN
+  auto const h = CreateFileA(path, write ? GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, NULL,
+                             write ? CREATE_ALWAYS : OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, NULL);
+  if (h != INVALID_HANDLE_VALUE) {
+    fd = ::_open_osfhandle(reinterpret_cast<intptr_t>(h), write ? _O_WRONLY : _O_RDONLY);
+    is_direct = fd >= 0;
+  }
+#else
+  int const flags = (write ? O_WRONLY | O_CREAT | O_TRUNC : O_RDONLY) | O_CLOEXEC;
+#if defined(O_DIRECT)
+  fd = ::open(path, flags | O_DIRECT, 0644);
+  is_direct = fd >= 0;
+  if (fd < 0 && errno == EINVAL) fd = ::open(path, flags, 0644);
+#else
+  fd = ::open(path, flags, 0644);
+#if defined(F_NOCACHE)
+  is_direct = fd >= 0 && ::fcntl(fd, F_NOCACHE, 1) == 0;
+#endif
+#endif
+#endif
+  if (fd < 0) KEXCEPT(Exception, "FileException : file \"" + std::string(path) + "\" not found");
+  return fd;
+}
+
+// where the page cache could not be bypassed, at least drop what was just transferred from it
+inline void forget([[maybe_unused]] int const fd, [[maybe_unused]] std::uint64_t const off,
+                   [[maybe_unused]] std::size_t const n) {
+#if defined(POSIX_FADV_DONTNEED)
+  ::posix_fadvise(fd, static_cast<off_t>(off), static_cast<off_t>(n), POSIX_FADV_DONTNEED);
+#endif
+}
+
+inline void close(int const fd) {
+#if MKN_KUL_IS_WIN
+  ::_close(fd);
+#else
+  ::close(fd);
+#endif
+}
+
+// two aligned buffers passed between the caller and one background thread
+class Pair {
+ public:
+  Pair(std::size_t const _block) : block(round(_block)) {
+    for (auto& s : slots) s.b.resize(this->block);
+  }
+
+  std::size_t const block;
+
+ protected:
+  struct Slot {
+    Buffer b;
+    std::size_t n = 0;
+    bool full = false;  // owned by the consumer of the pair when true
+  };
+  std::array<Slot, 2> slots;
+  std::mutex m;
+  std::condition_variable cv;
+  std::thread t;
+  int err = 0;
+  bool up = true;
+};
+
+}  // namespace direct
+
+// Sequential reads bypassing the page cache, so a scan does not evict the hot working set
+//  The next block is read on a background thread while the caller works on the current one.
+class DirectReader : public direct::Pair {
+ public:
+  DirectReader(char const* const path, std::size_t const _block = MKN_KUL_IO_DIRECT_BLOCK)
+      KTHROW(Exception)
+      : Pair(_block), fd(direct::open(path, false, is_direct)) {
+    t = std::thread([this]() { run(); });
+  }
+  DirectReader(File const& f, std::size_t const _block = MKN_KUL_IO_DIRECT_BLOCK)
+      : DirectReader(f.full().c_str(), _block) {}
+  ~DirectReader() {
+    {
+      std::lock_guard<std::mutex> l(m);
+      up = false;
+    }
+    cv.notify_all();
+    t.join();
+    direct::close(fd);
+  }
+
+  bool direct() const { return is_direct; }
+
+  // the next block of at most block bytes, empty at the end of the file, valid until next call
+  Span<std::uint8_t const> next() KTHROW(Exception) {
+    std::unique_lock<std::mutex> l(m);
+    if (held) {
+      slots[cur].full = false;
+      cur ^= 1;
+      held = false;
+      cv.notify_all();
+    }
+    cv.wait(l, [&]() { return slots[cur].full || err || done; });
+    if (slots[cur].full) {
+      held = true;
+      return {slots[cur].b.data(), slots[cur].n};
+    }
+    if (err) KEXCEPT(Exception, "DirectReader read failed: " + std::string(std::strerror(err)));
+    return {};
+  }
+
+ private:
+  bool is_direct = false, held = false, done = false;
+  int const fd;
+  std::size_t cur = 0;
+
+  void run() {
+    std::uint64_t off = 0;
+    for (std::size_t i = 0;; i ^= 1) {
+      {
+        std::unique_lock<std::mutex> l(m);
+        cv.wait(l, [&]() { return !up || !slots[i].full; });
+        if (!up) return;
+      }
+      auto& s = slots[i];
+      std::size_t n = 0;
+      std::int64_t r = 0;
+      // only the final read is short, the tail being whatever is left past the last block
+      while (n < block && (r = positional(fd, false, s.b.data() + n, block - n, off + n)) > 0)
+        n += static_cast<std::size_t>(r);
+      if (!is_direct && n) direct::forget(fd, off, n);
+      off += n;
+      {
+        std::lock_guard<std::mutex> l(m);
+        s.n = n;
+        s.full = n > 0;
+        if (r < 0) err = static_cast<int>(-r);
+        done = n < block;
+      }
+      cv.notify_all();
+      if (n < block) return;
+    }
+  }
+};
+
+// Sequential writes bypassing the page cache, written block by block from a background thread
+//  The final partial block is padded to the alignment and the file truncated back on close.
+class DirectWriter : public direct::Pair {
+ public:
+  DirectWriter(char const* const path, std::size_t const _block = MKN_KUL_IO_DIRECT_BLOCK)
+      KTHROW(Exception)
+      : Pair(_block), fd(direct::open(path, true, is_direct)) {
+    t = std::thread([this]() { run(); });
+  }
+  DirectWriter(File const& f, std::size_t const _block = MKN_KUL_IO_DIRECT_BLOCK)
+      : DirectWriter(f.full().c_str(), _block) {}
+  ~DirectWriter() {
+    try {
+      close();
+    } catch (...) {  // call close() to see errors
+    }
+  }
+
+  bool direct() const { return is_direct; }
+  std::uint64_t size() const { return total; }
+
+  DirectWriter& write(void const* const data, std::size_t n) KTHROW(Exception) {
+    if (fd < 0) KEXCEPT(Exception, "DirectWriter is closed");
+    auto const* c = static_cast<std::uint8_t const*>(data);
+    while (n) {
+      auto& s = slots[cur];
+      auto const w = (std::min)(n, block - s.n);
+      std::memcpy(s.b.data() + s.n, c, w);
+      s.n += w, c += w, n -= w, total += w;
+      if (s.n == block) hand();
+    }
+    return *this;
+  }
+  DirectWriter& write(Span<std::uint8_t const> const& s) KTHROW(Exception) {
+    return write(s.data(), s.size());
+  }
+
+  // writes the padded tail, waits for the writer and trims the file to what was written
+  //  the writer thread is joined and the file closed even if a write failed
+  void close() KTHROW(Exception) {
+    if (fd < 0) return;
+    auto& s = slots[cur];
+    if (s.n) {
+      std::memset(s.b.data() + s.n, 0, direct::round(s.n) - s.n);
+      pass(direct::round(s.n));
+    }
+    {
+      std::unique_lock<std::mutex> l(m);
+      cv.wait(l, [&]() { return err || (!slots[0].full && !slots[1].full); });
+      up = false;
+    }
+    cv.notify_all();
+    t.join();
+    auto e = err;
+#if MKN_KUL_IS_WIN
+    if (!e && ::_chsize_s(fd, static_cast<__int64>(total))) e = errno;
+#else
+    if (!e && ::ftruncate(fd, static_cast<off_t>(total))) e = errno;
+#endif
+    direct::close(fd);
+    fd = -1;
+    if (e) KEXCEPT(Exception, "DirectWriter write failed: " + std::string(std::strerror(e)));
+  }
+
+ private:
+  bool is_direct = false;
+  int fd;
+  std::size_t cur = 0;
+  std::uint64_t total = 0;
+
+  // passes the current slot to the writer thread, n bytes of it, and takes the other one
+  //  false if the writer thread has failed
+  bool pass(std::size_t const n = 0) {
+    std::unique_lock<std::mutex> l(m);
+    if (n) slots[cur].n = n;
+    slots[cur].full = true;
+    cv.notify_all();
+    cur ^= 1;
+    cv.wait(l, [&]() { return err || !slots[cur].full; });
+    slots[cur].n = 0;
+    return !err;
+  }
+  void hand() KTHROW(Exception) {
+    if (!pass()) KEXCEPT(Exception, "DirectWriter write failed: " + std::string(std::strerror(err)));
+  }
+
+  void run() {
+    std::uint64_t off = 0;
+    for (std::size_t i = 0;; i ^= 1) {
+      {
+        std::unique_lock<std::mutex> l(m);
+        cv.wait(l, [&]() { return !up || slots[i].full; });
+        if (!slots[i].full) return;
+      }
+      auto& s = slots[i];
+      std::int64_t r = 0;
+      for (std::size_t n = 0; n < s.n; n += static_cast<std::size_t>(r))
+        if ((r = positional(fd, true, s.b.data() + n, s.n - n, off + n)) <= 0) break;
+      if (!is_direct && r > 0) direct::forget(fd, off, s.n);
+      off += s.n;
+      {
+        std::lock_guard<std::mutex> l(m);
+        if (r <= 0) err = r < 0 ? static_cast<int>(-r) : EIO;
+        s.full = false;
+      }
+      cv.notify_all();
+      if (r <= 0) return;
+    }
+  }
+};
+
+}  // namespace mkn::kul::io
+
+#endif /* MKN_KUL_IO_DIRECT_HPP_ */
@@ -0,0 +1,158 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/io.hpp"
+
+#ifndef MKN_KUL_IO_LINE_HPP_
+#define MKN_KUL_IO_LINE_HPP_
+
+#include "mkn/kul/defs.hpp"
+#include "mkn/kul/except.hpp"
+
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <cstring>
+#include <utility>
+#include <optional>
+#include <string_view>
+
+#include <fcntl.h>
+#if MKN_KUL_IS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// initial LineReader buffer, it grows to fit the longest line
+#ifndef MKN_KUL_IO_LINE_BUFFER
+#define MKN_KUL_IO_LINE_BUFFER (1 << 16)
+#endif
+
+namespace mkn::kul::io {
+
+// Reads lines from a file descriptor through one large reused buffer, for pipes and other
+//  files that cannot be mapped. Line ends are found with memchr, which libc already scans
+//  with SIMD. Lines are views into the buffer, valid until the next readLine.
+class LineReader {
+ public:
+  // _fd is not closed by the reader
+  LineReader(int const _fd, std::size_t const buffer = MKN_KUL_IO_LINE_BUFFER)
+      : fd(_fd), cap(buffer ? buffer : 1), buf(new char[cap]) {}
+  LineReader(char const* const path, std::size_t const buffer = MKN_KUL_IO_LINE_BUFFER)
+      KTHROW(Exception)
+      : LineReader(open(path), buffer) {
+    own = true;
+  }
+  LineReader(File const& f, std::size_t const buffer = MKN_KUL_IO_LINE_BUFFER)
+      : LineReader(f.full().c_str(), buffer) {}
+  ~LineReader() {
+    if (!own) return;
+#if MKN_KUL_IS_WIN
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+  }
+
+  // split as io::Lines, nullopt at the end of input
+  std::optional<std::string_view> readLine() KTHROW(Exception) {
+    auto scanned = b;
+    for (;;) {
+      if (auto const* nl = static_cast<char*>(std::memchr(&buf[scanned], '\n', e - scanned))) {
+        std::string_view line(&buf[b], static_cast<std::size_t>(nl - &buf[b]));
+        b += line.size() + 1;
+        if (line.size() && line.back() == '\r') line.remove_suffix(1);
+        return line;
+      }
+      scanned = e;
+      if (eof) {
+        if (b == e) return std::nullopt;
+        std::string_view const line(&buf[b], e - b);
+        b = e;
+        return line;
+      }
+      fill();
+      scanned -= std::exchange(moved, 0);
+    }
+  }
+
+ private:
+  int fd;
+  bool own = false, eof = false;
+  std::size_t cap, b = 0, e = 0, moved = 0;
+  std::unique_ptr<char[]> buf;
+
+  static int open(char const* const path) KTHROW(Exception) {
+#if MKN_KUL_IS_WIN
+    auto const fd = ::_open(path, _O_RDONLY | _O_BINARY);
+#else
+    auto const fd = ::open(path, O_RDONLY | O_CLOEXEC);
+#endif
+    if (fd < 0) KEXCEPT(Exception, "FileException : file \"" + std::string(path) + "\" not found");
+    return fd;
+  }
+
+  // unread bytes are moved to the front only when the buffer has no room left behind them
+  void fill() KTHROW(Exception) {
+    if (e == cap && b) {
+      std::memmove(&buf[0], &buf[b], e - b);
+      moved = b;
+      e -= b;
+      b = 0;
+    } else if (e == cap) {
+      std::unique_ptr<char[]> next(new char[cap * 2]);
+      std::memcpy(&next[0], &buf[0], e);
+      buf = std::move(next);
+      cap *= 2;
+    }
+    for (;;) {
+#if MKN_KUL_IS_WIN
+      auto const r = ::_read(fd, &buf[e], static_cast<unsigned>(cap - e));
+#else
+      auto const r = ::read(fd, &buf[e], cap - e);
+#endif
+      if (r < 0 && errno == EINTR) continue;
+      if (r < 0) KEXCEPT(Exception, "LineReader read failed: " + std::string(std::strerror(errno)));
+      if (r == 0) eof = true;
+      e += static_cast<std::size_t>(r);
+      return;
+    }
+  }
+
+  LineReader(LineReader const&) = delete;
+  LineReader(LineReader&&) = delete;
+  LineReader& operator=(LineReader const&) = delete;
+  LineReader& operator=(LineReader&&) = delete;
+};
+
+}  // namespace mkn::kul::io
+
+#endif /* MKN_KUL_IO_LINE_HPP_ */
@@ -0,0 +1,250 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/io.hpp"
+
+#ifndef MKN_KUL_IO_MAP_HPP_
+#define MKN_KUL_IO_MAP_HPP_
+
+#include "mkn/kul/defs.hpp"
+#include "mkn/kul/except.hpp"
+
+#include <string>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+#if MKN_KUL_IS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace mkn::kul::io {
+
+// s split on '\n', a '\r' before it is dropped, a final line without '\n' is kept if not empty
+class Lines {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::string_view const*;
+    using reference = std::string_view const&;
+
+    iterator() = default;
+    iterator(std::string_view const s) : rest(s) { ++*this; }
+
+    reference operator*() const { return line; }
+    pointer operator->() const { return &line; }
+    iterator& operator++() {
+      if (rest.empty()) {
+        done = true;
+        return *this;
+      }
+      auto const* const nl =
+          static_cast<char const*>(std::memchr(rest.data(), '\n', rest.size()));
+      auto const n = nl ? static_cast<std::size_t>(nl - rest.data()) : rest.size();
+      line = rest.substr(0, n);
+      if (nl && line.size() && line.back() == '\r') line.remove_suffix(1);
+      rest.remove_prefix(nl ? n + 1 : n);
+      return *this;
+    }
+    iterator operator++(int) {
+      auto const i = *this;
+      ++*this;
+      return i;
+    }
+    bool operator==(iterator const& i) const {
+      return done == i.done && rest.data() == i.rest.data();
+    }
+    bool operator!=(iterator const& i) const { return !(*this == i); }
+
+    std::string_view remaining() const { return rest; }
+
+   private:
+    std::string_view rest, line;
+    bool done = false;
+  };
+
+  Lines(std::string_view const _s) : s(_s) {}
+  iterator begin() const { return iterator(s); }
+  iterator end() const {
+    iterator i(s.substr(s.size()));
+    return ++i;
+  }
+
+ private:
+  std::string_view s;
+};
+
+// s in consecutive views of n bytes, the last may be shorter
+class Chunks {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::string_view const*;
+    using reference = std::string_view;
+
+    iterator() = default;
+    iterator(std::string_view const s, std::size_t const _n) : rest(s), n(_n) {}
+
+    std::string_view operator*() const { return rest.substr(0, n); }
+    iterator& operator++() {
+      rest.remove_prefix(rest.size() < n ? rest.size() : n);
+      return *this;
+    }
+    iterator operator++(int) {
+      auto const i = *this;
+      ++*this;
+      return i;
+    }
+    bool operator==(iterator const& i) const { return rest.data() == i.rest.data(); }
+    bool operator!=(iterator const& i) const { return !(*this == i); }
+
+   private:
+    std::string_view rest;
+    std::size_t n = 1;
+  };
+
+  Chunks(std::string_view const _s, std::size_t const _n) : s(_s), n(_n ? _n : 1) {}
+  iterator begin() const { return iterator(s, n); }
+  iterator end() const { return iterator(s.substr(s.size()), n); }
+
+ private:
+  std::string_view s;
+  std::size_t n;
+};
+
+// Maps a whole file read only, lines and chunks are views into the mapping, nothing is copied
+//  Views stay valid for the life of the reader. The kernel is told the file is read front to
+//  back and to start reading ahead, so large files scan at memory bandwidth.
+class MappedReader {
+ public:
+  MappedReader(char const* const path) KTHROW(Exception) : p(path) {
+#if MKN_KUL_IS_WIN
+    h = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (h == INVALID_HANDLE_VALUE) fail("not found");
+    LARGE_INTEGER li;
+    if (!GetFileSizeEx(h, &li)) fail("size unknown");
+    n = static_cast<std::size_t>(li.QuadPart);
+    if (n == 0) return;
+    m = CreateFileMappingA(h, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m) fail("cannot be mapped");
+    d = static_cast<char const*>(MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0));
+    if (!d) fail("cannot be mapped");
+#else
+    fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) fail("not found");
+    struct stat st;
+    if (::fstat(fd, &st)) fail("size unknown");
+    n = static_cast<std::size_t>(st.st_size);
+    if (n == 0) return;
+    auto* const v = ::mmap(nullptr, n, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (v == MAP_FAILED) fail("cannot be mapped");
+    d = static_cast<char const*>(v);
+    ::madvise(v, n, MADV_SEQUENTIAL);
+    ::madvise(v, n, MADV_WILLNEED);
+#endif
+  }
+  MappedReader(File const& f) : MappedReader(f.full().c_str()) {}
+  ~MappedReader() { close(); }
+
+  char const* data() const { return d; }
+  std::size_t size() const { return n; }
+  std::string_view view() const { return {d, n}; }
+  std::string const& path() const { return p; }
+
+  Lines lines() const { return Lines(view()); }
+  Chunks chunks(std::size_t const size) const { return Chunks(view(), size); }
+
+  // next line from the current position, see Lines, nullopt once the file is exhausted
+  std::optional<std::string_view> readLine() {
+    if (o >= n) return std::nullopt;
+    Lines::iterator it(view().substr(o));
+    o = n - it.remaining().size();
+    return *it;
+  }
+  // up to l bytes from the current position, empty once the file is exhausted
+  std::string_view read(std::size_t const l) {
+    auto const v = view().substr(o < n ? o : n, l);
+    o += v.size();
+    return v;
+  }
+  void seek(std::size_t const l) { o = l < n ? l : n; }
+  std::size_t tell() const { return o; }
+
+ private:
+  std::string p;
+  char const* d = nullptr;
+  std::size_t n = 0, o = 0;
+#if MKN_KUL_IS_WIN
+  HANDLE h = INVALID_HANDLE_VALUE, m = NULL;
+#else
+  int fd = -1;
+#endif
+
+  void fail(char const* const why) KTHROW(Exception) {
+    close();
+    KEXCEPT(Exception, "FileException : file \"" + p + "\" " + why);
+  }
+  void close() {
+#if MKN_KUL_IS_WIN
+    if (d) UnmapViewOfFile(d);
+    if (m) CloseHandle(m);
+    if (h != INVALID_HANDLE_VALUE) CloseHandle(h);
+    h = INVALID_HANDLE_VALUE, m = NULL;
+#else
+    if (d) ::munmap(const_cast<char*>(d), n);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    d = nullptr;
+  }
+
+  MappedReader(MappedReader const&) = delete;
+  MappedReader(MappedReader&&) = delete;
+  MappedReader& operator=(MappedReader const&) = delete;
+  MappedReader& operator=(MappedReader&&) = delete;
+};
+
+}  // namespace mkn::kul::io
+
+#endif /* MKN_KUL_IO_MAP_HPP_ */
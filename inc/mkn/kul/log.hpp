@@ -36,12 +36,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "mkn/kul/env.hpp"
 #include "mkn/kul/time.hpp"
 #include "mkn/kul/except.hpp"
+#include "mkn/kul/string.hpp"
 #include "mkn/kul/threads/def.hpp"
 
+#include <ctime>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <sstream>
+#include <utility>
 #include <iostream>
+#include <optional>
 #include <functional>
+#include <string_view>
 
 #ifndef MKN_KUL_LOG_TIME_FRMT
 #define MKN_KUL_LOG_TIME_FRMT "%Y-%m-%d-%H:%M:%S:%i"
@@ -51,6 +61,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MKN_KUL_LOG_FRMT "[%M]: %T - %D : %F fn(%N)#%L - %S"
 #endif
 
+// most verbose mode compiled in, e.g. 2 keeps NON, INF and ERR and removes DBG, OTH and TRC
+#ifndef MKN_KUL_LOG_MIN_LEVEL
+#define MKN_KUL_LOG_MIN_LEVEL 5
+#endif
+
 namespace mkn {
 namespace kul {
 namespace log {
@@ -62,7 +77,193 @@ class Exception : public mkn::kul::Exception {
   Exception(char const* f, uint16_t const& l, std::string const& s)
       : mkn::kul::Exception(f, l, s) {}
 };
+
+inline char const* mode_text(mode const m) {
+  constexpr char const* txt[] = {"NON", "INF", "ERR", "DBG", "OTH", "TRC"};
+  return m > NON && m <= TRC ? txt[m] : txt[0];
+}
+
+// formatted once per thread
+inline std::string const& thread_id() {
+  static thread_local std::string const id = mkn::kul::this_thread::id();
+  return id;
+}
+
+// everything a format can refer to for one line
+struct Line {
+  mode m = NON;
+  std::string_view tid;
+  std::int64_t ns = 0;  // since epoch
+  char const *file = "", *fn = "";
+  std::uint16_t line = 0;
+  std::string_view msg;
+};
+
+// MKN_KUL_LOG_TIME_FRMT split around %i, the strftime parts are only redone when the second changes
+class DateFormat {
+ public:
+  DateFormat(std::string_view const fmt) {
+    for (std::size_t b = 0;;) {
+      auto const i = fmt.find("%i", b);
+      parts.emplace_back(fmt.substr(b, i == std::string_view::npos ? fmt.size() - b : i - b));
+      if (i == std::string_view::npos) break;
+      b = i + 2;
+    }
+  }
+  static DateFormat const& DEFAULT() {
+    static DateFormat const f(MKN_KUL_LOG_TIME_FRMT);
+    return f;
+  }
+
+  void emit(std::string& out, std::int64_t const ns) const {
+    struct Cache {
+      DateFormat const* f = nullptr;
+      std::int64_t sec = -1;
+      std::vector<std::string> parts;
+    };
+    static thread_local Cache c;
+    auto const sec = ns / 1000000000;
+    if (c.f != this || c.sec != sec) {
+      auto const t = static_cast<std::time_t>(sec);
+      struct tm ti;
+#ifdef _WIN32
+      localtime_s(&ti, &t);
+#else
+      localtime_r(&t, &ti);
+#endif
+      c.parts.resize(parts.size());
+      char buffer[80];
+      for (std::size_t i = 0; i < parts.size(); ++i)
+        c.parts[i].assign(buffer, std::strftime(buffer, 80, parts[i].c_str(), &ti));
+      c.f = this;
+      c.sec = sec;
+    }
+    auto const ms = (ns / 1000000) % 1000;
+    char const m[3] = {char('0' + ms / 100), char('0' + ms / 10 % 10), char('0' + ms % 10)};
+    for (std::size_t i = 0; i < c.parts.size(); ++i) {
+      if (i) out.append(m, 3);
+      out += c.parts[i];
+    }
+  }
+
+ private:
+  std::vector<std::string> parts;
+};
+
+// a log format parsed once into literal text and field segments, see MKN_KUL_LOG_FRMT
+class Format {
+  enum class Seg : std::uint8_t { TXT, MODE, THREAD, DATE, FILE, FUNC, LINE, MSG };
+
+ public:
+  Format(std::string_view const fmt) {
+    std::string txt;
+    for (std::size_t i = 0; i < fmt.size(); ++i) {
+      auto seg = Seg::TXT;
+      if (fmt[i] == '%' && i + 1 < fmt.size()) {
+        switch (fmt[i + 1]) {
+          case 'M':
+            seg = Seg::MODE;
+            break;
+          case 'T':
+            seg = Seg::THREAD;
+            break;
+          case 'D':
+            seg = Seg::DATE;
+            break;
+          case 'F':
+            seg = Seg::FILE;
+            break;
+          case 'N':
+            seg = Seg::FUNC;
+            break;
+          case 'L':
+            seg = Seg::LINE;
+            break;
+          case 'S':
+            seg = Seg::MSG;
+            break;
+          default:
+            break;
+        }
+      }
+      if (seg == Seg::TXT) {
+        txt += fmt[i];
+        continue;
+      }
+      if (!txt.empty()) segs.emplace_back(Seg::TXT, std::move(txt));
+      txt.clear();
+      segs.emplace_back(seg, std::string{});
+      ++i;
+    }
+    if (!txt.empty()) segs.emplace_back(Seg::TXT, std::move(txt));
+  }
+  static Format const& DEFAULT() {
+    static Format const f(MKN_KUL_LOG_FRMT);
+    return f;
+  }
+
+  void emit(std::string& out, Line const& l) const {
+    for (auto const& [seg, txt] : segs) {
+      switch (seg) {
+        case Seg::TXT:
+          out += txt;
+          break;
+        case Seg::MODE:
+          out += mode_text(l.m);
+          break;
+        case Seg::THREAD:
+          out += l.tid;
+          break;
+        case Seg::DATE:
+          DateFormat::DEFAULT().emit(out, l.ns);
+          break;
+        case Seg::FILE:
+          out += l.file;
+          break;
+        case Seg::FUNC:
+          out += l.fn;
+          break;
+        case Seg::LINE: {
+          char b[8];
+          auto* e = b + sizeof(b);
+          auto* p = e;
+          auto n = l.line;
+          do *--p = char('0' + n % 10);
+          while (n /= 10);
+          out.append(p, e);
+          break;
+        }
+        case Seg::MSG:
+          out += l.msg;
+          break;
+      }
+    }
+  }
+
+ private:
+  std::vector<std::pair<Seg, std::string>> segs;
+};
+
+// swallows a message expression so both branches of the ?: in MKN_KUL_LOG_IF_ are void
+struct Voidify {
+  template <typename T>
+  void operator&(T const&) const {}
+};
+
+inline std::int64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
 }  // namespace log
+}  // namespace kul
+}  // namespace mkn
+
+#include "mkn/kul/log/kv.hpp"
+
+namespace mkn {
+namespace kul {
 
 class ALogMan;
 class Logger {
@@ -70,32 +271,17 @@ class Logger {
 
  protected:
   std::function<void(std::string const&)> e, o;
-  std::string const modeTxt(log::mode const& m) const {
-    std::string s("NON");
-    if (m == 1)
-      s = "INF";
-    else if (m == 2)
-      s = "ERR";
-    else if (m == 3)
-      s = "DBG";
-    else if (m == 4)
-      s = "OTH";
-    else if (m == 5)
-      s = "TRC";
-    return s;
-  }
+  std::function<void(log::kv::Record const&)> k;
+  std::string const modeTxt(log::mode const& m) const { return log::mode_text(m); }
 
  public:
   virtual ~Logger() {}
+  // str is the format on entry and the formatted line on return
   void str(char const* f, char const* fn, uint16_t const& l, std::string const& s,
            log::mode const& m, std::string& str) {
-    mkn::kul::String::REPLACE(str, "%M", modeTxt(m));
-    mkn::kul::String::REPLACE(str, "%T", mkn::kul::this_thread::id());
-    mkn::kul::String::REPLACE(str, "%D", mkn::kul::DateTime::NOW(MKN_KUL_LOG_TIME_FRMT));
-    mkn::kul::String::REPLACE(str, "%F", f);
-    mkn::kul::String::REPLACE(str, "%N", fn);
-    mkn::kul::String::REPLACE(str, "%L", std::to_string(l));
-    mkn::kul::String::REPLACE(str, "%S", s);
+    log::Format const fmt(str);
+    str.clear();
+    fmt.emit(str, log::Line{m, log::thread_id(), log::now(), f, fn, l, s});
   }
   virtual void err(std::string const& s) {
     if (e)
@@ -109,14 +295,48 @@ class Logger {
     else
       std::cout << s;
   }
-  void log(char const* f, char const* fn, uint16_t const& l, std::string const& s,
+  void log(char const* f, char const* fn, uint16_t const& l, std::string_view const s,
            log::mode const& m) {
-    std::string st(MKN_KUL_LOG_FRMT);
-    str(f, fn, l, s, m, st);
-    out(st + mkn::kul::os::EOL());
+    buffered([&](std::string& st) {
+      log::Format::DEFAULT().emit(st, log::Line{m, log::thread_id(), log::now(), f, fn, l, s});
+      st += mkn::kul::os::EOL();
+    });
+  }
+  // a JSON line or binary record through out() unless a record sink is set
+  virtual void kv(log::kv::Record const& r) {
+    if (k) return k(r);
+    buffered([&](std::string& st) {
+      if (enc == log::kv::Encoding::BINARY) return log::kv::binary(r, st);
+      log::kv::json(r, st);
+      st += mkn::kul::os::EOL();
+    });
   }
   void setOut(std::function<void(std::string const&)> _o) { this->o = _o; }
   void setErr(std::function<void(std::string const&)> _e) { this->e = _e; }
+  void setKV(std::function<void(log::kv::Record const&)> _k) { this->k = _k; }
+  void setKV(log::kv::Encoding const _enc) { this->enc = _enc; }
+
+ private:
+  log::kv::Encoding enc = log::kv::Encoding::JSON;
+
+  // f fills a reused per thread buffer for out(), a fresh one is used if out() logs in turn
+  template <typename F>
+  void buffered(F&& f) {
+    static thread_local std::string buf;
+    static thread_local bool busy = false;
+    std::string tmp;
+    auto& st = busy ? tmp : buf;
+    auto const was = std::exchange(busy, true);
+    st.clear();
+    try {
+      f(st);
+      out(st);
+    } catch (...) {
+      busy = was;
+      throw;
+    }
+    busy = was;
+  }
 };
 
 class ALogMan {
@@ -151,17 +371,29 @@ class ALogMan {
  public:
   virtual ~ALogMan() {}
   void setMode(log::mode const& m1) { m = m1; }
+  log::mode const& mode() const { return m; }
   bool inf() { return m >= log::INF; }
   bool err() { return m >= log::ERR; }
   bool dbg() { return m >= log::DBG; }
   void log(char const* f, char const* fn, uint16_t const& l, log::mode const& _m,
-           std::string const& s) {
+           std::string_view const s) {
     if (this->m >= _m) logger->log(f, fn, l, s, _m);
   }
-  void out(log::mode const& _m, std::string const& s) {
-    if (this->m >= _m) logger->out(s + mkn::kul::os::EOL());
+  void out(log::mode const& _m, std::string_view const s) {
+    if (this->m >= _m) logger->out(std::string(s) += mkn::kul::os::EOL());
+  }
+  void err(std::string_view const s) { logger->err(std::string(s) += mkn::kul::os::EOL()); }
+  // args are key, value pairs, see KLOG_KV
+  template <typename... Args>
+  void kv(char const* f, char const* fn, uint16_t const& l, log::mode const& _m,
+          Args const&... args) {
+    static_assert(sizeof...(Args) % 2 == 0, "KLOG_KV takes key, value pairs");
+    if (this->m < _m) return;
+    log::kv::Field fs[sizeof...(Args) / 2 + 1];
+    if constexpr (sizeof...(Args) > 0) log::kv::fill(fs, args...);
+    logger->kv(log::kv::Record{_m, log::thread_id(), log::now(), f, fn, l, fs,
+                               sizeof...(Args) / 2});
   }
-  void err(std::string const& s) { logger->err(s + mkn::kul::os::EOL()); }
   std::string str(char const* f, char const* fn, uint16_t const& l, log::mode const& _m,
                   std::string const& s = "", std::string const fmt = MKN_KUL_LOG_FRMT) {
     std::string st(fmt);
@@ -170,6 +402,8 @@ class ALogMan {
   }
   void setOut(std::function<void(std::string const&)> o) { logger->setOut(o); }
   void setErr(std::function<void(std::string const&)> e) { logger->setErr(e); }
+  void setKV(std::function<void(log::kv::Record const&)> k) { logger->setKV(k); }
+  void setKV(log::kv::Encoding const enc) { logger->setKV(enc); }
 };
 
 class LogMan : public ALogMan {
@@ -183,17 +417,39 @@ class LogMan : public ALogMan {
   };
 };
 
+// strings, chars and numbers go to the builder, the first thing only an std::ostream can take
+//  (e.g. std::hex or a user type) moves the message into a stream for the rest of it
 class Message {
  protected:
-  std::stringstream ss;
+  StringBuilder<> sb;
+  std::optional<std::ostringstream> ss;
   log::mode const& m;
 
-  Message(log::mode const& _m) : m(_m) { ss.precision(22); }
+  Message(log::mode const& _m) : m(_m) {}
+
+  std::string_view str() {
+    if (ss) sb.clear(), sb.append(ss->view());
+    return sb.view();
+  }
 
  public:
   template <class T>
   Message& operator<<(T const& s) {
-    ss << s;
+    if constexpr (StringBuilder<>::appendable<T>) {
+      if (!ss) {
+        if constexpr (std::is_floating_point_v<T>)
+          sb.append(s, 22);
+        else
+          sb.append(s);
+        return *this;
+      }
+    }
+    if (!ss) {
+      ss.emplace();
+      ss->precision(22);
+      ss->write(sb.data(), static_cast<std::streamsize>(sb.size()));
+    }
+    *ss << s;
     return *this;
   }
 };
@@ -201,7 +457,7 @@ class LogMessage : public Message {
  public:
   LogMessage(char const* _f, char const* _fn, uint16_t const& _l, log::mode const& _m)
       : Message(_m), f(_f), fn(_fn), l(_l) {}
-  ~LogMessage() { LogMan::INSTANCE().log(f, fn, l, m, ss.str()); }
+  ~LogMessage() { LogMan::INSTANCE().log(f, fn, l, m, str()); }
 
  private:
   char const *f, *fn;
@@ -209,7 +465,7 @@ class LogMessage : public Message {
 };
 class DBgMessage : public Message {
  public:
-  ~DBgMessage() { MKN_KUL_DEBUG_DO(LogMan::INSTANCE().log(f, fn, l, m, ss.str())); }
+  ~DBgMessage() { MKN_KUL_DEBUG_DO(LogMan::INSTANCE().log(f, fn, l, m, str())); }
 
 #if !defined(NDEBUG)
   DBgMessage(char const* _f, char const* _fn, uint16_t const& _l, log::mode const& _m)
@@ -220,7 +476,7 @@ class DBgMessage : public Message {
 
   template <class T>
   DBgMessage& operator<<([[maybe_unused]] const T& s) {
-    MKN_KUL_DEBUG_DO(ss << s;)
+    MKN_KUL_DEBUG_DO(Message::operator<<(s);)
     return *this;
   }
 
@@ -230,55 +486,196 @@ class DBgMessage : public Message {
 };
 class OutMessage : public Message {
  public:
-  ~OutMessage() { LogMan::INSTANCE().out(m, ss.str()); }
+  ~OutMessage() { LogMan::INSTANCE().out(m, str()); }
   OutMessage(log::mode const& _m = mkn::kul::log::mode::NON) : Message(_m) {}
 };
 class ErrMessage : public Message {
  public:
-  ~ErrMessage() { LogMan::INSTANCE().err(ss.str()); }
+  ~ErrMessage() { LogMan::INSTANCE().err(str()); }
   ErrMessage() : Message(log::mode::ERR) {}
 };
 class DBoMessage : public Message {
  public:
-  ~DBoMessage() { MKN_KUL_DEBUG_DO(LogMan::INSTANCE().out(m, ss.str())); }
+  ~DBoMessage() { MKN_KUL_DEBUG_DO(LogMan::INSTANCE().out(m, str())); }
   DBoMessage(log::mode const& _m = mkn::kul::log::mode::NON) : Message(_m) {}
   template <class T>
   DBoMessage& operator<<([[maybe_unused]] T const& s) {
-    MKN_KUL_DEBUG_DO(ss << s;)
+    MKN_KUL_DEBUG_DO(Message::operator<<(s);)
     return *this;
   }
 };
 
+namespace log {
+
+// per call site state of the throttled KLOG macros, see KLOG_EVERY_N, KLOG_EVERY_MS and KLOG_RATE
+class Throttle {
+ protected:
+  std::atomic<std::uint64_t> skipped{0};
+
+  static std::int64_t ticks() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+  // a line saying how many were dropped goes out ahead of the next one let through
+  bool pass(bool const ok, char const* f, char const* fn, uint16_t const& l, log::mode const& m) {
+    if (!ok) {
+      skipped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (auto const s = skipped.exchange(0, std::memory_order_relaxed)) {
+      StringBuilder<64> sb;
+      LogMan::INSTANCE().log(f, fn, l, m, (sb << "suppressed " << s << " messages").view());
+    }
+    return true;
+  }
+
+ public:
+  std::uint64_t suppressed() const { return skipped.load(std::memory_order_relaxed); }
+};
+
+// the 1st, n+1th, 2n+1th ... call, the count dropped is implied so no summary is logged
+class EveryN {
+  std::atomic<std::uint64_t> c{0};
+
+ public:
+  bool allow(std::uint64_t const n) {
+    return n < 2 || c.fetch_add(1, std::memory_order_relaxed) % n == 0;
+  }
+};
+
+// at most one line per ms milliseconds
+class EveryMs : public Throttle {
+  std::atomic<std::int64_t> next{0};
+
+ public:
+  bool allow(std::int64_t const ms, char const* f, char const* fn, uint16_t const& l,
+             log::mode const& m) {
+    auto const now = ticks();
+    auto n = next.load(std::memory_order_relaxed);
+    bool const ok = now >= n && next.compare_exchange_strong(n, now + ms * 1000000,
+                                                             std::memory_order_relaxed);
+    return pass(ok, f, fn, l, m);
+  }
+};
+
+// token bucket refilled at per_sec, holding up to a second's worth (at least one)
+//  kept as the time the bucket is next full (GCRA), so one atomic covers it
+class Rate : public Throttle {
+  std::atomic<std::int64_t> tat{0};
+
+ public:
+  bool allow(double const per_sec, char const* f, char const* fn, uint16_t const& l,
+             log::mode const& m) {
+    if (per_sec <= 0) return pass(false, f, fn, l, m);
+    auto const gap = static_cast<std::int64_t>(1e9 / per_sec);
+    auto const burst = (per_sec > 1 ? std::int64_t{1000000000} : gap) - gap;
+    auto const now = ticks();
+    auto t = tat.load(std::memory_order_relaxed);
+    bool ok = false;
+    while (t - now <= burst)
+      if (tat.compare_exchange_weak(t, (t > now ? t : now) + gap, std::memory_order_relaxed)) {
+        ok = true;
+        break;
+      }
+    return pass(ok, f, fn, l, m);
+  }
+};
+
+}  // namespace log
+
 }  // namespace kul
 }  // namespace mkn
 
+// true if messages of mode sev are compiled in and currently enabled
+#define MKN_KUL_LOG_ON_(sev)                            \
+  (mkn::kul::log::mode::sev <= MKN_KUL_LOG_MIN_LEVEL && \
+   mkn::kul::LogMan::INSTANCE().mode() >= mkn::kul::log::mode::sev)
+
+// msg, including every streamed argument, is only evaluated if cond holds
+#define MKN_KUL_LOG_IF_(cond, msg) !(cond) ? (void)0 : mkn::kul::log::Voidify() & msg
+
 #if !defined(MKN_KUL_DISABLE_KLOG_DEF_) || MKN_KUL_DISABLE_KLOG_DEF_ == 1
 
-#define KLOG_NON mkn::kul::LogMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::NON)
-#define KLOG_INF mkn::kul::LogMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::INF)
-#define KLOG_ERR mkn::kul::LogMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::ERR)
+#define KLOG_NON                        \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(NON), \
+                  mkn::kul::LogMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::NON))
+#define KLOG_INF                        \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(INF), \
+                  mkn::kul::LogMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::INF))
+#define KLOG_ERR                        \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(ERR), \
+                  mkn::kul::LogMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::ERR))
 #define KLOG(sev) KLOG_##sev
 
 #if !defined(NDEBUG) || defined(KUL_FORCE_DBG_LOGS)
-#define KLOG_DBG mkn::kul::DBgMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::DBG)
-#define KLOG_OTH mkn::kul::DBgMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::OTH)
-#define KLOG_TRC mkn::kul::DBgMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::TRC)
+#define KLOG_DBG                        \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(DBG), \
+                  mkn::kul::DBgMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::DBG))
+#define KLOG_OTH                        \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(OTH), \
+                  mkn::kul::DBgMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::OTH))
+#define KLOG_TRC                        \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(TRC), \
+                  mkn::kul::DBgMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::TRC))
 #else
-#define KLOG_DBG mkn::kul::DBgMessage()
-#define KLOG_OTH mkn::kul::DBgMessage()
-#define KLOG_TRC mkn::kul::DBgMessage()
+#define KLOG_DBG MKN_KUL_LOG_IF_(false, mkn::kul::DBgMessage())
+#define KLOG_OTH MKN_KUL_LOG_IF_(false, mkn::kul::DBgMessage())
+#define KLOG_TRC MKN_KUL_LOG_IF_(false, mkn::kul::DBgMessage())
 #endif
 
-#define KOUT_NON mkn::kul::OutMessage()
-#define KOUT_INF mkn::kul::OutMessage(mkn::kul::log::mode::INF)
-#define KOUT_ERR mkn::kul::OutMessage(mkn::kul::log::mode::ERR)
-#define KOUT_DBG mkn::kul::DBoMessage(mkn::kul::log::mode::DBG)
-#define KOUT_OTH mkn::kul::DBoMessage(mkn::kul::log::mode::OTH)
-#define KOUT_TRC mkn::kul::DBoMessage(mkn::kul::log::mode::TRC)
+#define KOUT_NON MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(NON), mkn::kul::OutMessage())
+#define KOUT_INF \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(INF), mkn::kul::OutMessage(mkn::kul::log::mode::INF))
+#define KOUT_ERR \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(ERR), mkn::kul::OutMessage(mkn::kul::log::mode::ERR))
+#define KOUT_DBG \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(DBG), mkn::kul::DBoMessage(mkn::kul::log::mode::DBG))
+#define KOUT_OTH \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(OTH), mkn::kul::DBoMessage(mkn::kul::log::mode::OTH))
+#define KOUT_TRC \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_ON_(TRC), mkn::kul::DBoMessage(mkn::kul::log::mode::TRC))
 #define KOUT(sev) KOUT_##sev
 
 #define KERR mkn::kul::ErrMessage()
 
+// true if KLOG(sev) would log, DBG and above are only compiled into debug builds
+#if !defined(NDEBUG) || defined(KUL_FORCE_DBG_LOGS)
+#define MKN_KUL_LOG_KLOG_ON_(sev) MKN_KUL_LOG_ON_(sev)
+#else
+#define MKN_KUL_LOG_KLOG_ON_(sev) \
+  (mkn::kul::log::mode::sev < mkn::kul::log::mode::DBG && MKN_KUL_LOG_ON_(sev))
+#endif
+
+// a T unique to the expanding call site
+#define MKN_KUL_LOG_SITE_(T)   \
+  ([]() -> mkn::kul::log::T& { \
+    static mkn::kul::log::T s; \
+    return s;                  \
+  }())
+
+// KLOG(sev) subject to a per call site throttle, the condition is checked only if sev is enabled
+#define MKN_KUL_LOG_THROTTLED_(sev, cond)              \
+  MKN_KUL_LOG_IF_(MKN_KUL_LOG_KLOG_ON_(sev) && (cond), \
+                  mkn::kul::LogMessage(__FILE__, __func__, __LINE__, mkn::kul::log::mode::sev))
+
+// KLOG_EVERY_N(ERR, 100) << "bad input " << x; - the 1st, 101st, 201st ... time
+#define KLOG_EVERY_N(sev, n) MKN_KUL_LOG_THROTTLED_(sev, MKN_KUL_LOG_SITE_(EveryN).allow(n))
+// at most once every ms milliseconds
+#define KLOG_EVERY_MS(sev, ms)                                                                   \
+  MKN_KUL_LOG_THROTTLED_(sev, MKN_KUL_LOG_SITE_(EveryMs).allow(ms, __FILE__, __func__, __LINE__, \
+                                                                mkn::kul::log::mode::sev))
+// at most per_sec a second on average, bursts of up to per_sec
+#define KLOG_RATE(sev, per_sec)                                                                    \
+  MKN_KUL_LOG_THROTTLED_(sev, MKN_KUL_LOG_SITE_(Rate).allow(per_sec, __FILE__, __func__, __LINE__, \
+                                                             mkn::kul::log::mode::sev))
+
+// KLOG_KV(INF, "req", id, "lat_us", us) - typed fields, encoded as JSON or binary by the logger
+#define KLOG_KV(sev, ...)                                                                \
+  (!MKN_KUL_LOG_ON_(sev) ? (void)0                                                       \
+                         : mkn::kul::LogMan::INSTANCE().kv(__FILE__, __func__, __LINE__, \
+                                                           mkn::kul::log::mode::sev, __VA_ARGS__))
+
 #endif  //! defined(MKN_KUL_DISABLE_KLOG_DEF_)
 
 #endif /* MKN_KUL_LOG_HPP */
@@ -0,0 +1,381 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_LOG_DEFER_HPP_
+#define MKN_KUL_LOG_DEFER_HPP_
+
+#include "mkn/kul/log.hpp"
+#include "mkn/kul/queue.hpp"
+#include "mkn/kul/threads/def.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <sstream>
+#include <charconv>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <condition_variable>
+
+#if MKN_KUL_IS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// bytes per logging thread, a full ring makes the logging thread wait for the consumer
+#ifndef MKN_KUL_LOG_DEFER_RING
+#define MKN_KUL_LOG_DEFER_RING (1 << 16)
+#endif
+
+// how long the consumer sleeps when every ring is empty
+#ifndef MKN_KUL_LOG_DEFER_POLL_US
+#define MKN_KUL_LOG_DEFER_POLL_US 1000
+#endif
+
+namespace mkn::kul::log {
+namespace defer {
+
+// static per call site, the arguments alone travel through the ring
+struct Site {
+  char const *file, *fn;
+  std::uint16_t line;
+  log::mode m;
+  char const* fmt;  // "{}" is replaced by each argument in turn
+};
+
+// arguments are copied into the ring as raw bytes and only turned into text by the consumer
+//  fixed is the size before any string bytes, strings are cut to at most cap bytes
+template <typename T, typename = void>
+struct Codec;
+
+template <typename T>
+struct Codec<T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>> {
+  static constexpr std::size_t fixed = sizeof(T);
+  static constexpr bool cut = false;
+
+  static constexpr std::size_t size(T const&, std::size_t) { return sizeof(T); }
+  static void write(unsigned char*& p, T const& t, std::size_t) {
+    std::memcpy(p, &t, sizeof(T));
+    p += sizeof(T);
+  }
+  static void append(unsigned char const*& p, std::string& out) {
+    T t;
+    std::memcpy(&t, p, sizeof(T));
+    p += sizeof(T);
+    if constexpr (std::is_same_v<T, char>)
+      out += t;
+    else if constexpr (std::is_same_v<T, bool>)
+      out += t ? '1' : '0';
+    else if constexpr (std::is_enum_v<T>)
+      append_(static_cast<std::underlying_type_t<T>>(t), out);
+    else
+      append_(t, out);
+  }
+
+ private:
+  template <typename V>
+  static void append_(V const v, std::string& out) {
+    char b[64];
+    auto const r = std::to_chars(b, b + sizeof(b), v);
+    out.append(b, r.ptr);
+  }
+};
+
+template <typename T>
+struct Codec<T, std::enable_if_t<std::is_same_v<T, std::string> ||
+                                 std::is_same_v<T, std::string_view> ||
+                                 std::is_same_v<T, char const*>>> {
+  static std::string_view view(std::string_view const s) { return s; }
+  static std::string_view view(char const* const s) { return s ? s : "(null)"; }
+
+  static constexpr std::size_t fixed = sizeof(std::uint32_t);
+  static constexpr bool cut = true;
+
+  static std::size_t size(T const& t, std::size_t const cap) {
+    return fixed + (std::min)(view(t).size(), cap);
+  }
+  static void write(unsigned char*& p, T const& t, std::size_t const cap) {
+    auto const s = view(t);
+    auto const n = static_cast<std::uint32_t>((std::min)(s.size(), cap));
+    std::memcpy(p, &n, sizeof(n));
+    std::memcpy(p + sizeof(n), s.data(), n);
+    p += sizeof(n) + n;
+  }
+  static void append(unsigned char const*& p, std::string& out) {
+    std::uint32_t n;
+    std::memcpy(&n, p, sizeof(n));
+    out.append(reinterpret_cast<char const*>(p + sizeof(n)), n);
+    p += sizeof(n) + n;
+  }
+};
+
+// the type an argument travels as, anything without a Codec is streamed to a std::string
+template <typename T, typename D = std::decay_t<T>>
+using arg_t = std::conditional_t<
+    std::is_arithmetic_v<D> || std::is_enum_v<D> || std::is_same_v<D, std::string> ||
+        std::is_same_v<D, std::string_view>,
+    D, std::conditional_t<std::is_same_v<D, char*> || std::is_same_v<D, char const*>, char const*,
+                          std::string>>;
+
+template <typename T>
+decltype(auto) arg(T const& t) {
+  if constexpr (std::is_same_v<arg_t<T>, std::string> &&
+                !std::is_same_v<std::decay_t<T>, std::string>) {
+    std::ostringstream ss;
+    ss.precision(22);
+    ss << t;
+    return ss.str();
+  } else if constexpr (std::is_same_v<arg_t<T>, char const*>)
+    return static_cast<char const*>(t);
+  else
+    return (t);
+}
+
+// appends the next argument's text to out, advancing p past its bytes
+using Decoder = void (*)(Site const&, unsigned char const*, std::string&);
+
+template <typename... Args>
+void decode(Site const& site, unsigned char const* p, std::string& out) {
+  std::string_view const fmt(site.fmt);
+  std::size_t at = 0;
+  [[maybe_unused]] auto const one = [&](auto&& append) {
+    auto const b = fmt.find("{}", at);
+    out.append(fmt.substr(at, b == std::string_view::npos ? fmt.size() - at : b - at));
+    if (b == std::string_view::npos) {
+      at = fmt.size();
+      out += ' ';
+    } else
+      at = b + 2;
+    append(p, out);
+  };
+  (one(Codec<Args>::append), ...);
+  if (at < fmt.size()) out.append(fmt.substr(at));
+}
+
+// record layout: Site const*, Decoder, nanoseconds since epoch, encoded arguments
+struct Header {
+  Site const* site;
+  Decoder decode;
+  std::int64_t ns;
+};
+
+}  // namespace defer
+
+// Log lines are captured as a call site pointer plus the raw argument bytes into a ring owned by
+//  the calling thread. One background thread formats them and writes in batches with write(2),
+//  so the logging thread never formats, allocates (after its first line) or takes a lock.
+//  Lines from one thread keep their order, lines across threads are not interleaved mid line.
+class DeferredLogger {
+  using Ring = mkn::kul::SPSCRing<MKN_KUL_LOG_DEFER_RING>;
+  struct Producer {
+    Ring ring;
+    std::string tid = mkn::kul::this_thread::id();
+    std::atomic<bool> closed{0};
+  };
+  struct Holder {
+    std::shared_ptr<Producer> p;
+    ~Holder() {
+      if (p) p->closed = 1;
+    }
+  };
+
+ public:
+  static DeferredLogger& INSTANCE() {
+    static DeferredLogger instance;
+    return instance;
+  }
+  ~DeferredLogger() {
+    {
+      std::lock_guard<std::mutex> l(_m);
+      _up = 0;
+    }
+    _cv.notify_all();
+    if (_consumer.joinable()) _consumer.join();
+  }
+
+  template <typename... Args>
+  void log(defer::Site const& site, Args const&... args) {
+    push<defer::arg_t<Args>...>(site, defer::arg(args)...);
+  }
+
+  // blocks until every line logged before the call has been written
+  void flush() {
+    std::unique_lock<std::mutex> l(_m);
+    auto const target = _passes + 2;  // a pass already running may have missed earlier lines
+    if (_requested < target) _requested = target;
+    _cv.notify_all();
+    _done_cv.wait(l, [&]() { return !_up || _passes >= target; });
+  }
+
+  // file descriptor lines are written to, stdout by default
+  void fd(int const f) { _fd = f; }
+
+ private:
+  template <typename... Ts, typename... Args>
+  void push(defer::Site const& site, Args const&... args) {
+    using namespace defer;
+    constexpr std::size_t fixed = sizeof(Header) + (std::size_t{0} + ... + Codec<Ts>::fixed);
+    // largest record that always fits an empty ring, whether or not it would wrap
+    constexpr std::size_t room = Ring::capacity() / 2 - 8;
+    static_assert(fixed <= room, "KDEFER arguments can never fit MKN_KUL_LOG_DEFER_RING");
+    auto& p = producer();
+    // strings too long for the ring are cut, each to an equal share of what is left
+    std::size_t cap = Ring::capacity();
+    std::size_t n = sizeof(Header) + (std::size_t{0} + ... + Codec<Ts>::size(args, cap));
+    if constexpr ((false || ... || Codec<Ts>::cut))
+      if (n > room) {
+        cap = (room - fixed) / (std::size_t{0} + ... + std::size_t{Codec<Ts>::cut});
+        n = sizeof(Header) + (std::size_t{0} + ... + Codec<Ts>::size(args, cap));
+      }
+    unsigned char* b = nullptr;
+    while (!(b = p.ring.reserve(n))) {
+      wake();
+      std::this_thread::yield();
+    }
+    Header const h{&site, &decode<Ts...>, log::now()};
+    std::memcpy(b, &h, sizeof(h));
+    [[maybe_unused]] auto* w = b + sizeof(h);
+    (Codec<Ts>::write(w, args, cap), ...);
+    p.ring.commit(n);
+  }
+
+  std::atomic<int> _fd{1};
+  bool _up = 1;
+  std::size_t _requested = 0, _passes = 0;
+  std::mutex _m, _pm;
+  std::condition_variable _cv, _done_cv;
+  std::vector<std::shared_ptr<Producer>> _producers;  // guarded by _pm
+  std::string _msg;  // consumer only
+  std::thread _consumer;
+
+  DeferredLogger() : _consumer([this]() { consume(); }) {}
+
+  Producer& producer() {
+    static thread_local Holder h;
+    if (!h.p) {
+      h.p = std::make_shared<Producer>();
+      std::lock_guard<std::mutex> l(_pm);
+      _producers.emplace_back(h.p);
+    }
+    return *h.p;
+  }
+
+  void wake() {
+    std::lock_guard<std::mutex> l(_m);
+    _cv.notify_all();
+  }
+
+  void consume() {
+    std::string batch;
+    std::vector<std::shared_ptr<Producer>> ps;
+    for (;;) {
+      std::size_t pass = 0;
+      bool up = 1;
+      {
+        std::unique_lock<std::mutex> l(_m);
+        _cv.wait_for(l, std::chrono::microseconds(MKN_KUL_LOG_DEFER_POLL_US),
+                     [&]() { return !_up || _requested > _passes; });
+        up = _up;
+        pass = _passes + 1;
+      }
+      {
+        std::lock_guard<std::mutex> l(_pm);
+        ps = _producers;
+      }
+      for (auto const& p : ps)
+        p->ring.drain([&](unsigned char const* b, std::size_t) {
+          format(b, p->tid, batch);
+          if (batch.size() >= (1 << 16)) write(batch);
+        });
+      write(batch);
+      {
+        std::lock_guard<std::mutex> l(_pm);
+        std::erase_if(_producers, [](auto const& p) { return p->closed && p->ring.empty(); });
+      }
+      {
+        std::lock_guard<std::mutex> l(_m);
+        _passes = pass;
+      }
+      _done_cv.notify_all();
+      if (!up) break;
+    }
+  }
+
+  void format(unsigned char const* b, std::string const& tid, std::string& out) {
+    defer::Header h;
+    std::memcpy(&h, b, sizeof(h));
+    _msg.clear();
+    h.decode(*h.site, b + sizeof(h), _msg);
+    log::Format::DEFAULT().emit(
+        out, log::Line{h.site->m, tid, h.ns, h.site->file, h.site->fn, h.site->line, _msg});
+    out += mkn::kul::os::EOL();
+  }
+
+  void write(std::string& batch) {
+    std::size_t off = 0;
+    while (off < batch.size()) {
+#if MKN_KUL_IS_WIN
+      auto const w = ::_write(_fd, batch.data() + off, static_cast<unsigned>(batch.size() - off));
+#else
+      auto const w = ::write(_fd, batch.data() + off, batch.size() - off);
+#endif
+      if (w <= 0) break;  // nowhere left to report it
+      off += w;
+    }
+    batch.clear();
+  }
+
+  DeferredLogger(DeferredLogger const&) = delete;
+  DeferredLogger(DeferredLogger&&) = delete;
+  DeferredLogger& operator=(DeferredLogger const&) = delete;
+  DeferredLogger& operator=(DeferredLogger&&) = delete;
+};
+
+}  // namespace mkn::kul::log
+
+// KDEFER(INF, "took {}ms for {}", ms, name) - arguments are copied, formatting is deferred
+#define KDEFER(sev, FMT, ...)                                           \
+  do {                                                                  \
+    if (MKN_KUL_LOG_ON_(sev)) {                                         \
+      static mkn::kul::log::defer::Site const _kul_defer_site{          \
+          __FILE__, __func__, __LINE__, mkn::kul::log::mode::sev, FMT}; \
+      mkn::kul::log::DeferredLogger::INSTANCE().log(                    \
+          _kul_defer_site __VA_OPT__(, ) __VA_ARGS__);                  \
+    }                                                                   \
+  } while (0)
+
+#endif /* MKN_KUL_LOG_DEFER_HPP_ */
@@ -0,0 +1,322 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_LOG_FILE_HPP_
+#define MKN_KUL_LOG_FILE_HPP_
+
+#include "mkn/kul/log.hpp"
+#include "mkn/kul/time.hpp"
+#include "mkn/kul/threads.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <condition_variable>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#if MKN_KUL_IS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+namespace mkn::kul::log {
+
+// Buffered, rotating log file, pass to setOut/setErr with std::ref(sink)
+//  Logging threads only append to an in memory buffer under a short lock, a background thread
+//  swaps the buffer out and writes it with one call, so no logging thread waits on the disk.
+//  Lines past max_pending bytes are dropped and counted rather than blocking.
+class FileSink {
+ public:
+  struct Config {
+    std::size_t flush_bytes = 1 << 20;                // wake the writer once this much is buffered
+    std::chrono::milliseconds interval{1000};         // otherwise write at least this often
+    std::size_t max_pending = std::size_t{64} << 20;  // buffered bytes before lines are dropped
+    std::size_t max_bytes = 0;                        // rotate before a file exceeds this, 0 never
+    std::chrono::seconds max_age{0};                  // rotate files older than this, 0 never
+    std::size_t keep = 0;                             // rotated files kept, oldest removed, 0 all
+    // given each rotated file off the writer thread, eg to compress it, returns its new path
+    std::function<std::string(std::string const&)> on_rotate;
+  };
+
+  FileSink(std::string const& path) : FileSink(path, Config{}) {}
+  FileSink(std::string const& path, Config const& c) KTHROW(log::Exception)
+      : _path(path), _c(c) {
+    open();
+    _writer = std::thread([this]() { write_loop(); });
+    if (_c.on_rotate || _c.keep) _post = std::thread([this]() { post_loop(); });
+  }
+  ~FileSink() {
+    {
+      std::lock_guard<std::mutex> l(_m);
+      _up = 0;
+    }
+    _cv.notify_all();
+    if (_writer.joinable()) _writer.join();
+    {
+      std::lock_guard<std::mutex> l(_m);
+      _post_up = 0;
+    }
+    _post_cv.notify_all();
+    if (_post.joinable()) _post.join();
+    close();
+  }
+
+  void operator()(std::string const& s) { append(s); }
+  void append(std::string_view const s) {
+    bool wake = 0;
+    {
+      mkn::kul::ScopeLock l(_bm);
+      if (_active.size() + s.size() > _c.max_pending) {
+        ++_dropped;
+        return;
+      }
+      _active.append(s.data(), s.size());
+      wake = _active.size() >= _c.flush_bytes && !_woken;
+      if (wake) _woken = 1;
+    }
+    if (wake) _cv.notify_one();  // unlocked, a missed wake up is covered by the interval
+  }
+
+  // blocks until every line appended before the call has been written
+  void flush() {
+    std::unique_lock<std::mutex> l(_m);
+    auto const target = _passes + 2;  // a pass already running may have missed earlier lines
+    if (_requested < target) _requested = target;
+    _cv.notify_all();
+    _done_cv.wait(l, [&]() { return !_up || _passes >= target; });
+  }
+
+  std::string const& path() const { return _path; }
+  std::size_t dropped() const { return _dropped_total.load(); }
+
+ private:
+  std::string const _path;
+  Config const _c;
+
+  AdaptiveMutex _bm;  // guards _active, _woken and _dropped
+  std::string _active;
+  bool _woken = 0;
+  std::size_t _dropped = 0;
+  std::atomic<std::size_t> _dropped_total{0};
+
+  bool _up = 1, _post_up = 1;
+  std::size_t _requested = 0, _passes = 0;
+  std::mutex _m;  // guards the above and _rotated
+  std::condition_variable _cv, _done_cv, _post_cv;
+  std::deque<std::string> _rotated;
+
+  int _fd = -1;  // writer only from here
+  std::size_t _size = 0;
+  std::chrono::steady_clock::time_point _opened;
+  std::deque<std::string> _kept;  // post thread only
+  std::thread _writer, _post;
+
+  void open() {
+#if MKN_KUL_IS_WIN
+    _fd = ::_open(_path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+                  _S_IREAD | _S_IWRITE);
+#else
+    _fd = ::open(_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+    if (_fd < 0) KEXCEPT(log::Exception, "Cannot open log file: " + _path);
+    struct stat st;
+    _size = ::fstat(_fd, &st) == 0 ? static_cast<std::size_t>(st.st_size) : 0;
+    _opened = std::chrono::steady_clock::now();
+  }
+  void close() {
+    if (_fd < 0) return;
+#if MKN_KUL_IS_WIN
+    ::_close(_fd);
+#else
+    ::close(_fd);
+#endif
+    _fd = -1;
+  }
+
+  void write_loop() {
+    std::string batch, note;
+    for (;;) {
+      std::size_t pass = 0;
+      bool up = 1;
+      {
+        std::unique_lock<std::mutex> l(_m);
+        _cv.wait_for(l, _c.interval, [&]() { return !_up || _requested > _passes || woken(); });
+        up = _up;
+        pass = _passes + 1;
+      }
+      std::size_t dropped = 0;
+      {
+        mkn::kul::ScopeLock l(_bm);
+        batch.swap(_active);  // _active keeps the capacity of the last batch
+        _woken = 0;
+        dropped = std::exchange(_dropped, 0);
+      }
+      if (dropped) {
+        _dropped_total += dropped;
+        note = "log::FileSink dropped " + std::to_string(dropped) + " lines" + os::EOL();
+      }
+      try {
+        put(note, batch);
+      } catch (...) {  // eg the file cannot be reopened, open is retried next pass
+        _dropped_total += static_cast<std::size_t>(std::count(batch.begin(), batch.end(), '\n'));
+      }
+      note.clear();
+      batch.clear();
+      {
+        std::lock_guard<std::mutex> l(_m);
+        _passes = pass;
+      }
+      _done_cv.notify_all();
+      if (!up) break;
+    }
+  }
+  bool woken() {
+    mkn::kul::ScopeLock l(_bm);
+    return _woken;
+  }
+
+  // writes whole lines, rotating first whenever the next would take the file past max_bytes
+  //  if the file cannot be renamed the rest of the batch goes into it regardless
+  void put(std::string_view note, std::string_view b) KTHROW(log::Exception) {
+    if (_fd < 0) open();
+    bool can = 1;
+    auto const rotated = [&]() { return can && (can = rotate()); };
+    if (_c.max_age.count() && _size && std::chrono::steady_clock::now() - _opened >= _c.max_age)
+      rotated();
+    while (b.size()) {
+      auto n = b.size();
+      auto const used = _size + note.size();
+      if (_c.max_bytes && used + n > _c.max_bytes) {
+        auto const room = _c.max_bytes > used ? _c.max_bytes - used : 0;
+        auto const nl = room ? b.rfind('\n', room - 1) : std::string_view::npos;
+        if (nl != std::string_view::npos)
+          n = nl + 1;
+        else if (_size && rotated())
+          continue;
+        else {  // a line longer than max_bytes gets a file to itself
+          auto const e = b.find('\n');
+          n = e == std::string_view::npos ? b.size() : e + 1;
+        }
+      }
+      write(note, b.substr(0, n));
+      b.remove_prefix(n);
+      note = {};
+      if (_c.max_bytes && _size >= _c.max_bytes && b.size()) rotated();
+    }
+    if (note.size()) write(note, b);
+  }
+
+  void write(std::string_view a, std::string_view b) {
+    _size += a.size() + b.size();
+#if MKN_KUL_IS_WIN
+    for (auto s : {a, b})
+      while (s.size()) {
+        auto const w = ::_write(_fd, s.data(), static_cast<unsigned>(s.size()));
+        if (w <= 0) return;  // nowhere left to report it
+        s.remove_prefix(w);
+      }
+#else
+    struct iovec io[2] = {{const_cast<char*>(a.data()), a.size()},
+                          {const_cast<char*>(b.data()), b.size()}};
+    struct iovec* v = a.size() ? io : io + 1;
+    int c = a.size() ? 2 : 1;
+    while (c) {
+      auto w = ::writev(_fd, v, c);
+      if (w <= 0) return;
+      while (c && static_cast<std::size_t>(w) >= v->iov_len) {
+        w -= v->iov_len;
+        ++v, --c;
+      }
+      if (c) {
+        v->iov_base = static_cast<char*>(v->iov_base) + w;
+        v->iov_len -= w;
+      }
+    }
+#endif
+  }
+
+  // <path>.<YYYYmmdd-HHMMSS>[.n], the file is handed to the post thread once renamed
+  //  false if it could not be, it is then reopened as it was
+  bool rotate() KTHROW(log::Exception) {
+    close();
+    auto const base = _path + "." + DateTime::NOW("%Y%m%d-%H%M%S");
+    auto to = base;
+    struct stat st;
+    for (std::size_t i = 1; ::stat(to.c_str(), &st) == 0; ++i) to = base + "." + std::to_string(i);
+    bool const moved = std::rename(_path.c_str(), to.c_str()) == 0;
+    open();
+    if (!moved || !_post.joinable()) return moved;
+    {
+      std::lock_guard<std::mutex> l(_m);
+      _rotated.emplace_back(to);
+    }
+    _post_cv.notify_one();
+    return true;
+  }
+
+  void post_loop() {
+    for (;;) {
+      std::string f;
+      {
+        std::unique_lock<std::mutex> l(_m);
+        _post_cv.wait(l, [&]() { return !_post_up || _rotated.size(); });
+        if (_rotated.empty()) break;
+        f = std::move(_rotated.front());
+        _rotated.pop_front();
+      }
+      if (_c.on_rotate) try {
+          f = _c.on_rotate(f);
+        } catch (...) {  // the file stays where it is
+        }
+      if (!_c.keep) continue;
+      _kept.emplace_back(std::move(f));
+      for (; _kept.size() > _c.keep; _kept.pop_front()) std::remove(_kept.front().c_str());
+    }
+  }
+
+  FileSink(FileSink const&) = delete;
+  FileSink(FileSink&&) = delete;
+  FileSink& operator=(FileSink const&) = delete;
+  FileSink& operator=(FileSink&&) = delete;
+};
+
+}  // namespace mkn::kul::log
+
+#endif /* MKN_KUL_LOG_FILE_HPP_ */
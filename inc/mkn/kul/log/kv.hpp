@@ -0,0 +1,277 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/log.hpp"
+
+#ifndef MKN_KUL_LOG_KV_HPP_
+#define MKN_KUL_LOG_KV_HPP_
+
+#include <cmath>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+namespace mkn::kul::log {
+namespace kv {
+
+enum class Encoding : std::uint8_t { JSON, BINARY };
+enum class Type : std::uint8_t { NUL, BOOL, INT, UINT, REAL, STR };
+
+// one field value as given, strings are viewed not copied, conversion is left to the encoder
+//  types without a direct representation are streamed into a string owned by the value
+class Value {
+ public:
+  Type type = Type::NUL;
+  union {
+    bool b;
+    std::int64_t i;
+    std::uint64_t u;
+    double d;
+  };
+  std::string_view s;
+
+  Value() : u(0) {}
+  Value(Value const& v) : type(v.type), s(v.s), own(v.own) { copy(v); }
+  Value& operator=(Value const& v) {
+    type = v.type, s = v.s, own = v.own;
+    copy(v);
+    return *this;
+  }
+
+  template <typename T>
+  void set(T const& t) {
+    if constexpr (std::is_same_v<T, bool>)
+      type = Type::BOOL, b = t;
+    else if constexpr (std::is_enum_v<T>)
+      set(static_cast<std::underlying_type_t<T>>(t));
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+      type = Type::INT, i = t;
+    else if constexpr (std::is_integral_v<T>)
+      type = Type::UINT, u = t;
+    else if constexpr (std::is_floating_point_v<T>)
+      type = Type::REAL, d = static_cast<double>(t);
+    else if constexpr (std::is_same_v<T, std::nullptr_t>)
+      type = Type::NUL;
+    else if constexpr (std::is_array_v<T>)
+      set(std::string_view(t));
+    else if constexpr (std::is_convertible_v<T const&, char const*>)
+      set(std::string_view(t ? static_cast<char const*>(t) : "(null)"));
+    else if constexpr (std::is_convertible_v<T const&, std::string_view>)
+      type = Type::STR, s = std::string_view(t);
+    else {
+      std::ostringstream ss;
+      ss << t;
+      own = std::move(ss).str();
+      type = Type::STR, s = own;
+    }
+  }
+
+ private:
+  std::string own;
+
+  // the union as is, a streamed string is viewed in this value's own copy
+  void copy(Value const& v) {
+    std::memcpy(&u, &v.u, sizeof(u));
+    if (v.s.data() == v.own.data()) s = own;
+  }
+};
+
+struct Field {
+  std::string_view key;
+  Value value;
+};
+
+// one KLOG_KV call, fields refer to the arguments so a Record only lives for the call
+struct Record {
+  mode m = NON;
+  std::string_view tid;
+  std::int64_t ns = 0;  // since epoch
+  char const *file = "", *fn = "";
+  std::uint16_t line = 0;
+  Field const* fields = nullptr;
+  std::size_t size = 0;
+};
+
+template <typename K, typename V, typename... Rest>
+void fill(Field* f, K const& k, V const& v, Rest const&... rest) {
+  static_assert(std::is_convertible_v<K const&, std::string_view>, "KLOG_KV keys must be strings");
+  f->key = k;
+  f->value.set(v);
+  if constexpr (sizeof...(Rest) > 0) fill(f + 1, rest...);
+}
+
+namespace detail {
+template <typename T>
+void num(std::string& out, T const t) {
+  char b[32];
+  auto const r = std::to_chars(b, b + sizeof(b), t);
+  out.append(b, r.ptr);
+}
+inline void str(std::string& out, std::string_view const s) {
+  constexpr char hex[] = "0123456789abcdef";
+  out += '"';
+  std::size_t b = 0;
+  for (std::size_t i = 0; i < s.size(); ++i) {
+    auto const c = static_cast<unsigned char>(s[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') continue;
+    out.append(s.data() + b, i - b);
+    b = i + 1;
+    out += '\\';
+    switch (c) {
+      case '"':
+      case '\\':
+        out += char(c);
+        break;
+      case '\n':
+        out += 'n';
+        break;
+      case '\r':
+        out += 'r';
+        break;
+      case '\t':
+        out += 't';
+        break;
+      default:
+        out += "u00";
+        out += hex[c >> 4];
+        out += hex[c & 15];
+    }
+  }
+  out.append(s.data() + b, s.size() - b);
+  out += '"';
+}
+template <typename T>
+void raw(std::string& out, T const t) {
+  out.append(reinterpret_cast<char const*>(&t), sizeof(T));
+}
+inline void raw(std::string& out, std::string_view const s) {
+  raw(out, static_cast<std::uint32_t>(s.size()));
+  out.append(s.data(), s.size());
+}
+}  // namespace detail
+
+// {"ts":<ns since epoch>,"level":"INF","tid":"..","file":"..","fn":"..","line":N,<fields>}
+//  non finite reals are written as null, no line ending is added
+inline void json(Record const& r, std::string& out) {
+  using namespace detail;
+  out += "{\"ts\":";
+  num(out, r.ns);
+  out += ",\"level\":\"";
+  out += mode_text(r.m);
+  out += "\",\"tid\":";
+  str(out, r.tid);
+  out += ",\"file\":";
+  str(out, r.file);
+  out += ",\"fn\":";
+  str(out, r.fn);
+  out += ",\"line\":";
+  num(out, r.line);
+  for (std::size_t i = 0; i < r.size; ++i) {
+    auto const& [k, v] = r.fields[i];
+    out += ',';
+    str(out, k);
+    out += ':';
+    switch (v.type) {
+      case Type::NUL:
+        out += "null";
+        break;
+      case Type::BOOL:
+        out += v.b ? "true" : "false";
+        break;
+      case Type::INT:
+        num(out, v.i);
+        break;
+      case Type::UINT:
+        num(out, v.u);
+        break;
+      case Type::REAL:
+        if (std::isfinite(v.d))
+          num(out, v.d);
+        else
+          out += "null";
+        break;
+      case Type::STR:
+        str(out, v.s);
+        break;
+    }
+  }
+  out += '}';
+}
+
+// host byte order, strings are a u32 length then the bytes
+//  u32 record bytes after this field, i64 ns, u8 mode, u16 line, str tid, str file, str fn,
+//  u16 field count, then per field: str key, u8 Type, value (bool u8, 8 bytes, str or nothing)
+inline void binary(Record const& r, std::string& out) {
+  using namespace detail;
+  auto const at = out.size();
+  raw(out, std::uint32_t{0});
+  raw(out, r.ns);
+  raw(out, static_cast<std::uint8_t>(r.m));
+  raw(out, r.line);
+  raw(out, r.tid);
+  raw(out, std::string_view(r.file));
+  raw(out, std::string_view(r.fn));
+  raw(out, static_cast<std::uint16_t>(r.size));
+  for (std::size_t i = 0; i < r.size; ++i) {
+    auto const& [k, v] = r.fields[i];
+    raw(out, k);
+    raw(out, static_cast<std::uint8_t>(v.type));
+    switch (v.type) {
+      case Type::NUL:
+        break;
+      case Type::BOOL:
+        raw(out, static_cast<std::uint8_t>(v.b));
+        break;
+      case Type::INT:
+        raw(out, v.i);
+        break;
+      case Type::UINT:
+        raw(out, v.u);
+        break;
+      case Type::REAL:
+        raw(out, v.d);
+        break;
+      case Type::STR:
+        raw(out, v.s);
+        break;
+    }
+  }
+  auto const n = static_cast<std::uint32_t>(out.size() - at - sizeof(std::uint32_t));
+  std::memcpy(out.data() + at, &n, sizeof(n));
+}
+
+}  // namespace kv
+}  // namespace mkn::kul::log
+
+#endif /* MKN_KUL_LOG_KV_HPP_ */
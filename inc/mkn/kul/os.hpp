@@ -43,7 +43,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <vector>
+#include <utility>
 #include <optional>
+#include <functional>
 
 namespace mkn {
 namespace kul {
@@ -91,11 +93,7 @@ class Dir : public fs::Item {
   }
   static inline std::string LOCL(std::string s);
   static void ESC_REPLACE(std::string& s, std::string const& f, std::string const& r) {
-    size_t p = s.find(f);
-    while (p != std::string::npos) {
-      s.replace(s.find(f, p), f.size(), r);
-      p = s.find(f, p + r.size());
-    }
+    mkn::kul::String::REPLACE_ALL(s, f, r);
   }
   static inline std::string ESC(std::string s);
   static std::string PRNT(std::string const& s) {  // parent
@@ -233,11 +231,9 @@ class File : public fs::Item {
     if (!d.is() && !d.mk()) KEXCEPT(fs::Exception, "Directory: \"" + _d.path() + "\" is not valid");
     return cp(mkn::kul::File(name(), d._p));
   }
-  bool cp(File const& f) const {
-    std::ifstream src(_d.join(_n), std::ios::binary);
-    std::ofstream dst(f.dir().join(f.name()), std::ios::binary);
-    return (bool)(dst << src.rdbuf());
-  }
+  // in kernel where possible, a reflink, copy_file_range or sendfile on Linux, fcopyfile on
+  //  macOS and CopyFileA on Windows, else streamed through user space
+  inline bool cp(File const& f) const;
 
   inline bool is() const;
   inline bool mk() const;
@@ -276,15 +272,38 @@ class File : public fs::Item {
     rel += Dir::SEP() + r.name();
     return rel;
   }
+
+ private:
+  bool streamCp(File const& f) const {
+    std::ifstream src(_d.join(_n), std::ios::binary);
+    std::ofstream dst(f.dir().join(f.name()), std::ios::binary);
+    if (!src || !dst) return false;
+    if (src.peek() == std::ifstream::traits_type::eof()) return true;  // empty sets failbit
+    return (bool)(dst << src.rdbuf());
+  }
 };
 
+namespace fs {
+// makes the directories of s inside d and lists every file copy that needs, source then target
+inline std::vector<std::pair<File, File>> tree(Dir const& s, Dir const& d) KTHROW(Exception) {
+  if (!d.is() && !d.mk()) KEXCEPT(Exception, "Directory: \"" + d.path() + "\" is not valid");
+  std::vector<std::pair<File, File>> todo;
+  std::function<void(Dir const&, Dir const&)> const walk = [&](Dir const& from, Dir const& to) {
+    Dir c(to.join(from.name()));
+    c.mk();
+    for (auto const& f : from.files()) todo.emplace_back(f, File(f.name(), c));
+    for (auto const& dd : from.dirs()) walk(dd, c);
+  };
+  walk(s, d);
+  return todo;
+}
+}  // namespace fs
+
+// see mkn/kul/os/cp.hpp to copy the files in parallel
 inline bool mkn::kul::Dir::cp(Dir const& d) const {
-  if (!d.is() && !d.mk()) KEXCEPT(fs::Exception, "Directory: \"" + d.path() + "\" is not valid");
-  Dir c(d.join(name()));
-  c.mk();
-  for (auto const& f : files()) f.cp(c);
-  for (auto const& dd : dirs()) dd.cp(c);
-  return 1;
+  bool ok = true;
+  for (auto const& [from, to] : fs::tree(*this, d)) ok = from.cp(to) && ok;
+  return ok;
 }
 
 inline std::ostream& operator<<(std::ostream& s, File const& d) { return s << d.full(); }
@@ -0,0 +1,130 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/cpu.hpp"
+
+#ifndef MKN_KUL_OS_ANY_CPU_DEF_HPP_
+#define MKN_KUL_OS_ANY_CPU_DEF_HPP_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+namespace mkn::kul::cpu {
+
+// one logical cpu, cache ids are the lowest cpu id sharing that cache
+struct Processor {
+  std::uint32_t id = 0, core = 0, socket = 0, node = 0, l2 = 0, l3 = 0;
+};
+
+class Topology {
+ public:
+  Topology() {}
+  Topology(std::vector<Processor>&& _cpus) : cpus(std::move(_cpus)) {}
+
+  // each logical cpu as its own core, on one socket and node
+  static Topology flat(std::uint32_t const n) {
+    std::vector<Processor> ps(std::max<std::uint32_t>(1, n));
+    for (std::uint32_t i = 0; i < ps.size(); ++i) ps[i] = Processor{i, i, 0, 0, i, 0};
+    return Topology(std::move(ps));
+  }
+
+  std::vector<Processor> const& processors() const { return cpus; }
+  Processor const* find(std::uint32_t const id) const {
+    for (auto const& p : cpus)
+      if (p.id == id) return &p;
+    return nullptr;
+  }
+
+  std::size_t sockets() const { return count([](auto const& p) { return p.socket; }); }
+  std::size_t nodes() const { return count([](auto const& p) { return p.node; }); }
+  std::size_t cores() const { return primaries().size(); }
+
+  // first logical cpu of each physical core, grouped by node then socket
+  std::vector<std::uint32_t> primaries() const {
+    std::vector<Processor> ps;
+    for (auto const& p : cpus)
+      if (std::none_of(ps.begin(), ps.end(), [&](auto const& c) {
+            return c.socket == p.socket && c.core == p.core;
+          }))
+        ps.emplace_back(p);
+    std::stable_sort(ps.begin(), ps.end(), [](auto const& a, auto const& b) {
+      return a.node != b.node ? a.node < b.node : a.socket < b.socket;
+    });
+    std::vector<std::uint32_t> ids;
+    for (auto const& p : ps) ids.emplace_back(p.id);
+    return ids;
+  }
+
+  // logical cpus sharing the level 2 or 3 cache of cpu id
+  std::vector<std::uint32_t> sharing(std::uint32_t const id, std::uint8_t const level) const {
+    std::vector<std::uint32_t> ids;
+    auto const* c = find(id);
+    if (!c) return ids;
+    for (auto const& p : cpus)
+      if (level == 2 ? p.l2 == c->l2 : p.l3 == c->l3) ids.emplace_back(p.id);
+    return ids;
+  }
+
+  // parses kernel cpu lists like "0-3,8,10-11"
+  static std::vector<std::uint32_t> parse(std::string const& s) {
+    std::vector<std::uint32_t> ids;
+    for (std::size_t b = 0; b < s.size();) {
+      auto e = s.find(',', b);
+      if (e == std::string::npos) e = s.size();
+      auto const r = s.substr(b, e - b);
+      if (!r.empty() && r[0] >= '0' && r[0] <= '9') {
+        auto const d = r.find('-');
+        auto const lo = std::strtoul(r.c_str(), nullptr, 10);
+        auto const hi = d == std::string::npos ? lo : std::strtoul(r.c_str() + d + 1, nullptr, 10);
+        for (auto i = lo; i <= hi; ++i) ids.emplace_back(static_cast<std::uint32_t>(i));
+      }
+      b = e + 1;
+    }
+    return ids;
+  }
+
+ private:
+  template <typename F>
+  std::size_t count(F const& f) const {
+    std::vector<std::uint32_t> seen;
+    for (auto const& p : cpus)
+      if (std::find(seen.begin(), seen.end(), f(p)) == seen.end()) seen.emplace_back(f(p));
+    return seen.size();
+  }
+
+  std::vector<Processor> cpus;
+};
+
+}  // namespace mkn::kul::cpu
+
+#endif /* MKN_KUL_OS_ANY_CPU_DEF_HPP_ */
@@ -213,10 +213,10 @@ inline void AProcess::start() KTHROW(mkn::kul::Exception) {
 }
 
 inline std::string AProcess::toString() const {
-  std::string _s;
-  for (std::string const& a : args()) _s += a + " ";
-  _s.pop_back();
-  return _s;
+  StringBuilder<> sb;
+  for (std::string const& a : args()) sb << a << ' ';
+  if (!sb.empty()) sb.pop_back();
+  return sb.str();
 }
 
 }  // namespace mkn::kul
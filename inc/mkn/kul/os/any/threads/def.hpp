@@ -39,6 +39,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <chrono>
 #include <exception>
 #include <thread>
+#include <vector>
+#include <cstdint>
 
 namespace mkn::kul::this_thread {
 inline void sleep(unsigned long const& millis) {
@@ -69,6 +71,7 @@ class AThread {
  protected:
   std::atomic<bool> f, s;
   std::exception_ptr ep;
+  std::vector<std::uint32_t> cpus;
 
   AThread() : f(1), s(0) {}
   virtual void run() KTHROW(mkn::kul::threading::Exception) = 0;
@@ -79,6 +82,9 @@ class AThread {
   bool started() const { return s; }
   bool finished() const { return f; }
   auto& exception() const { return ep; }
+  // logical cpus the thread may run on, applied by the next run(), empty for no restriction
+  void affinity(std::vector<std::uint32_t> const& _cpus) { cpus = _cpus; }
+  auto& affinity() const { return cpus; }
   void rethrow() {
     if (ep) std::rethrow_exception(ep);
   }
@@ -46,6 +46,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fstream>
 #include <thread>
 
+#include "mkn/kul/os/any/cpu/def.hpp"
+
 namespace mkn {
 namespace kul {
 namespace cpu {
@@ -74,6 +76,12 @@ inline uint32_t cores() {
   return numCPU;
 }
 inline uint16_t threads() { return std::thread::hardware_concurrency(); }
+
+// topology is not discovered here, each logical cpu is reported as its own core
+inline Topology const& topology() {
+  static Topology const t = Topology::flat(threads());
+  return t;
+}
 }  // namespace cpu
 }  // namespace kul
 }  // namespace mkn
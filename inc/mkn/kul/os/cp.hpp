@@ -0,0 +1,58 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_OS_CP_HPP_
+#define MKN_KUL_OS_CP_HPP_
+
+#include "mkn/kul/os.hpp"
+#include "mkn/kul/parallel.hpp"
+
+#include <atomic>
+
+namespace mkn::kul {
+
+// Dir::cp with the files copied at once on the pool, the directories are made first
+//  false if any copy failed
+template <typename E>
+bool parallel_cp(WorkStealingPool<E>& pool, Dir const& s, Dir const& d) KTHROW(fs::Exception) {
+  auto const todo = fs::tree(s, d);
+  std::atomic<bool> ok{true};
+  parallel::run(pool, todo.size(), [&](std::size_t const i) {
+    if (!todo[i].first.cp(todo[i].second)) ok.store(false, std::memory_order_relaxed);
+  });
+  return ok.load();
+}
+inline bool parallel_cp(Dir const& s, Dir const& d) KTHROW(fs::Exception) {
+  return parallel_cp(parallel::pool(), s, d);
+}
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_OS_CP_HPP_ */
@@ -35,6 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <dirent.h>
 #include <pwd.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
@@ -42,13 +43,75 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <unistd.h>
 #include <algorithm>
 #include <fstream>
+#include <string>
 #include <thread>
 
+#include "mkn/kul/os/any/cpu/def.hpp"
+
 namespace mkn {
 namespace kul {
 namespace cpu {
-inline uint32_t cores() { return sysconf(_SC_NPROCESSORS_ONLN); }
-inline uint16_t threads() { return std::thread::hardware_concurrency(); }
+inline uint32_t cores() { return static_cast<uint32_t>(sysconf(_SC_NPROCESSORS_ONLN)); }
+inline uint16_t threads() { return static_cast<uint16_t>(std::thread::hardware_concurrency()); }
+
+namespace detail {
+inline std::string sys_read(std::string const& path) {
+  std::string s;
+  std::ifstream f(path);
+  if (f) std::getline(f, s);
+  return s;
+}
+inline bool sys_read(std::string const& path, uint32_t& v) {
+  auto const s = sys_read(path);
+  if (s.empty()) return false;
+  v = static_cast<uint32_t>(std::strtoul(s.c_str(), nullptr, 10));
+  return true;
+}
+}  // namespace detail
+
+// read once from /sys/devices/system/cpu, missing entries fall back to flat values
+//  only cpus the process may run on are listed, eg within a container or taskset
+inline Topology const& topology() {
+  static Topology const t = []() {
+    std::string const root = "/sys/devices/system/cpu/";
+    auto ids = Topology::parse(detail::sys_read(root + "online"));
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+      std::erase_if(ids, [&](auto const id) {
+        return id < static_cast<uint32_t>(CPU_SETSIZE) && !CPU_ISSET(id, &set);
+      });
+    if (ids.empty()) return Topology::flat(threads());
+    std::vector<Processor> ps;
+    for (auto const id : ids) {
+      auto const dir = root + "cpu" + std::to_string(id) + "/";
+      Processor p{id, id, 0, 0, id, 0};
+      detail::sys_read(dir + "topology/physical_package_id", p.socket);
+      detail::sys_read(dir + "topology/core_id", p.core);
+      if (auto* d = opendir(dir.c_str())) {
+        while (auto* e = readdir(d)) {
+          std::string const n(e->d_name);
+          if (n.size() > 4 && n.compare(0, 4, "node") == 0 && n[4] >= '0' && n[4] <= '9')
+            p.node = static_cast<uint32_t>(std::strtoul(n.c_str() + 4, nullptr, 10));
+        }
+        closedir(d);
+      }
+      for (uint32_t i = 0;; ++i) {
+        auto const cache = dir + "cache/index" + std::to_string(i) + "/";
+        uint32_t level = 0;
+        if (!detail::sys_read(cache + "level", level)) break;
+        if (detail::sys_read(cache + "type") == "Instruction") continue;
+        auto const shared = Topology::parse(detail::sys_read(cache + "shared_cpu_list"));
+        if (shared.empty()) continue;
+        if (level == 2) p.l2 = *std::min_element(shared.begin(), shared.end());
+        if (level == 3) p.l3 = *std::min_element(shared.begin(), shared.end());
+      }
+      ps.emplace_back(p);
+    }
+    return Topology(std::move(ps));
+  }();
+  return t;
+}
 }  // namespace cpu
 }  // namespace kul
 }  // namespace mkn
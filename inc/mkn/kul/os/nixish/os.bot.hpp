@@ -84,6 +84,19 @@ bool mkn::kul::File::mk() const {
   }
   return pFile != NULL;
 }
+bool mkn::kul::File::cp(File const& f) const {
+  int const in = ::open(_d.join(_n).c_str(), O_RDONLY | O_CLOEXEC);
+  if (in < 0) return false;
+  struct stat att;
+  int const out = ::fstat(in, &att) == 0 && S_ISREG(att.st_mode)
+                      ? ::open(f.dir().join(f.name()).c_str(),
+                               O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666)
+                      : -1;
+  auto const r = out < 0 ? -1 : fs::KCOPY(in, out, static_cast<std::uint64_t>(att.st_size));
+  ::close(in);
+  if (out >= 0) ::close(out);
+  return r < 0 ? streamCp(f) : r == 1;
+}
 uint64_t mkn::kul::File::size() const {
   uint64_t r = 0;
   struct stat att;
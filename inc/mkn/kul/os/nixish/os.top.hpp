@@ -34,16 +34,29 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MKN_KUL_OS_NIXISH_OS_TOP_HPP_
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <pwd.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#if defined(__linux__)
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#elif defined(__APPLE__)
+#include <copyfile.h>
+#endif
+#include <cerrno>
+#include <cstdint>
 #include <algorithm>
 #include <fstream>
 #include <thread>
 
+#if defined(__linux__) && !defined(FICLONE)
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
 namespace mkn {
 namespace kul {
 
@@ -63,6 +76,39 @@ class KulTimeStampsResolver {
   friend class mkn::kul::Dir;
 };
 
+// copies size bytes from in to out without passing through user space, a reflink shares the
+//  blocks outright on btrfs/xfs. 1 on success, 0 on failure, -1 if no kernel path applies and
+//  nothing was written so the caller can fall back to streaming
+inline int KCOPY(int const in, int const out, std::uint64_t const size) {
+#if defined(__linux__)
+  if (::ioctl(out, FICLONE, in) == 0) return 1;
+  if (size == 0) return -1;  // eg /proc files report no size but have content
+  bool range = true;
+  for (std::uint64_t done = 0; done < size;) {
+    auto const n = static_cast<std::size_t>(std::min<std::uint64_t>(size - done, 1u << 30));
+    auto const w = range ? ::copy_file_range(in, nullptr, out, nullptr, n, 0)
+                         : ::sendfile(out, in, nullptr, n);
+    if (w < 0 && errno == EINTR) continue;
+    if (w < 0 && done == 0 &&
+        (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)) {
+      if (!range) return -1;
+      range = false;
+      continue;
+    }
+    if (w < 0) return 0;
+    if (w == 0) break;  // source shrank
+    done += static_cast<std::uint64_t>(w);
+  }
+  return 1;
+#elif defined(__APPLE__)
+  (void)size;
+  return ::fcopyfile(in, out, nullptr, COPYFILE_DATA) == 0 ? 1 : -1;
+#else
+  (void)in, (void)out, (void)size;
+  return -1;
+#endif
+}
+
 }  // namespace fs
 }  // namespace kul
 }  // namespace mkn
@@ -34,10 +34,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MKN_KUL_OS_NIXISH_THREADS_OS_HPP_
 
 #include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <string>
+#include <cstring>
+
 #include "mkn/kul/os/nixish/threads/def.hpp"
 
 namespace mkn {
@@ -56,11 +60,46 @@ class Mutex {
     pthread_mutexattr_destroy(&att);
   }
   ~Mutex() { pthread_mutex_destroy(&mute); }
-  bool tryLock() { return pthread_mutex_trylock(&mute); }
+  bool tryLock() { return pthread_mutex_trylock(&mute) == 0; }
   void lock() { pthread_mutex_lock(&mute); }
   void unlock() { pthread_mutex_unlock(&mute); }
 };
 
+// non-recursive, relocking from the owning thread deadlocks
+class PlainMutex {
+ private:
+  pthread_mutex_t mute = PTHREAD_MUTEX_INITIALIZER;
+
+ public:
+  PlainMutex() {}
+  ~PlainMutex() { pthread_mutex_destroy(&mute); }
+  bool tryLock() { return pthread_mutex_trylock(&mute) == 0; }
+  void lock() { pthread_mutex_lock(&mute); }
+  void unlock() { pthread_mutex_unlock(&mute); }
+
+  PlainMutex(PlainMutex const&) = delete;
+  PlainMutex& operator=(PlainMutex const&) = delete;
+};
+
+// many readers or one writer, non-recursive
+class RWLock {
+ private:
+  pthread_rwlock_t rw = PTHREAD_RWLOCK_INITIALIZER;
+
+ public:
+  RWLock() {}
+  ~RWLock() { pthread_rwlock_destroy(&rw); }
+  bool tryLock() { return pthread_rwlock_trywrlock(&rw) == 0; }
+  void lock() { pthread_rwlock_wrlock(&rw); }
+  void unlock() { pthread_rwlock_unlock(&rw); }
+  bool tryLockShared() { return pthread_rwlock_tryrdlock(&rw) == 0; }
+  void lockShared() { pthread_rwlock_rdlock(&rw); }
+  void unlockShared() { pthread_rwlock_unlock(&rw); }
+
+  RWLock(RWLock const&) = delete;
+  RWLock& operator=(RWLock const&) = delete;
+};
+
 class Thread : public threading::AThread {
  private:
   std::function<void()> func;
@@ -103,7 +142,26 @@ class Thread : public threading::AThread {
     if (s) KEXCEPTION("Thread running");
     f = 0;
     s = 1;
-    pthread_create(&thr, NULL, Thread::threadFunction, this);
+    int r = -1;
+#if defined(__GLIBC__)
+    if (cpus.size()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (auto const c : cpus)
+        if (c < CPU_SETSIZE) CPU_SET(c, &set);
+      pthread_attr_t att;
+      pthread_attr_init(&att);
+      if (pthread_attr_setaffinity_np(&att, sizeof(set), &set) == 0)
+        r = pthread_create(&thr, &att, Thread::threadFunction, this);
+      pthread_attr_destroy(&att);
+    }
+#endif
+    // a pin outside the process cpuset is refused, the thread then runs unpinned
+    if (r != 0 && (r = pthread_create(&thr, nullptr, Thread::threadFunction, this)) != 0) {
+      s = 0;
+      f = 1;
+      KEXCEPTION("Thread creation failed: " + std::string(std::strerror(r)));
+    }
   }
 };
 
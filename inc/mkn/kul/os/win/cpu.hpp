@@ -34,6 +34,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <windows.h>
 
 #include <thread>
+#include <vector>
+
+#include "mkn/kul/os/any/cpu/def.hpp"
 
 namespace mkn {
 namespace kul {
@@ -44,6 +47,48 @@ inline uint32_t cores() {
   return sysinfo.dwNumberOfProcessors;
 }
 inline uint16_t threads() { return std::thread::hardware_concurrency(); }
+
+// first processor group only, so at most 64 logical cpus (32 on 32 bit)
+inline Topology const& topology() {
+  static Topology const t = []() {
+    DWORD len = 0;
+    GetLogicalProcessorInformation(nullptr, &len);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(
+        len / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (info.empty() || !GetLogicalProcessorInformation(info.data(), &len))
+      return Topology::flat(threads());
+    constexpr uint32_t bits = sizeof(ULONG_PTR) * 8;
+    std::vector<Processor> ps;
+    for (uint32_t i = 0; i < bits; ++i) ps.emplace_back(Processor{i, i, 0, 0, i, 0});
+    auto const lowest = [](ULONG_PTR m) {
+      uint32_t b = 0;
+      while (m && !(m & 1)) m >>= 1, ++b;
+      return b;
+    };
+    uint32_t core = 0, socket = 0;
+    ULONG_PTR all = 0;
+    for (auto const& in : info) {
+      auto const m = in.ProcessorMask;
+      for (uint32_t i = 0; i < bits; ++i) {
+        if (!(m & (ULONG_PTR(1) << i))) continue;
+        if (in.Relationship == RelationProcessorCore) ps[i].core = core, all |= m;
+        if (in.Relationship == RelationProcessorPackage) ps[i].socket = socket;
+        if (in.Relationship == RelationNumaNode) ps[i].node = in.NumaNode.NodeNumber;
+        if (in.Relationship == RelationCache && in.Cache.Type != CacheInstruction) {
+          if (in.Cache.Level == 2) ps[i].l2 = lowest(m);
+          if (in.Cache.Level == 3) ps[i].l3 = lowest(m);
+        }
+      }
+      if (in.Relationship == RelationProcessorCore) ++core;
+      if (in.Relationship == RelationProcessorPackage) ++socket;
+    }
+    std::vector<Processor> online;
+    for (auto const& p : ps)
+      if (all & (ULONG_PTR(1) << p.id)) online.emplace_back(p);
+    return Topology(std::move(online));
+  }();
+  return t;
+}
 }  // namespace cpu
 }  // namespace kul
 }  // namespace mkn
@@ -82,6 +82,11 @@ bool mkn::kul::File::mk() const {
   return pFile != NULL;
 }
 
+bool mkn::kul::File::cp(File const& f) const {
+  // block clones on ReFS and copies server side on SMB shares
+  if (CopyFileA(_d.join(_n).c_str(), f.dir().join(f.name()).c_str(), FALSE)) return true;
+  return streamCp(f);
+}
 uint64_t mkn::kul::File::size() const {
   uint64_t r = 0;
   WIN32_FIND_DATA ffd;
@@ -46,10 +46,44 @@ class Mutex {
  public:
   Mutex() { InitializeCriticalSection(&critSec); }
   ~Mutex() { DeleteCriticalSection(&critSec); }
+  bool tryLock() { return TryEnterCriticalSection(&critSec); }
   void lock() { EnterCriticalSection(&critSec); }
   void unlock() { LeaveCriticalSection(&critSec); }
 };
 
+// non-recursive, relocking from the owning thread deadlocks
+class PlainMutex {
+ private:
+  SRWLOCK srw = SRWLOCK_INIT;
+
+ public:
+  PlainMutex() {}
+  bool tryLock() { return TryAcquireSRWLockExclusive(&srw); }
+  void lock() { AcquireSRWLockExclusive(&srw); }
+  void unlock() { ReleaseSRWLockExclusive(&srw); }
+
+  PlainMutex(PlainMutex const&) = delete;
+  PlainMutex& operator=(PlainMutex const&) = delete;
+};
+
+// many readers or one writer, non-recursive
+class RWLock {
+ private:
+  SRWLOCK srw = SRWLOCK_INIT;
+
+ public:
+  RWLock() {}
+  bool tryLock() { return TryAcquireSRWLockExclusive(&srw); }
+  void lock() { AcquireSRWLockExclusive(&srw); }
+  void unlock() { ReleaseSRWLockExclusive(&srw); }
+  bool tryLockShared() { return TryAcquireSRWLockShared(&srw); }
+  void lockShared() { AcquireSRWLockShared(&srw); }
+  void unlockShared() { ReleaseSRWLockShared(&srw); }
+
+  RWLock(RWLock const&) = delete;
+  RWLock& operator=(RWLock const&) = delete;
+};
+
 namespace threading {
 DWORD WINAPI threadFunction(LPVOID th);
 }
@@ -93,7 +127,16 @@ class Thread : public threading::AThread {
     if (s) KEXCEPTION("Thread running");
     f = 0;
     s = 1;
-    h = CreateThread(0, 5120000, threading::threadFunction, this, 0, 0);
+    if (cpus.empty()) {
+      h = CreateThread(0, 5120000, threading::threadFunction, this, 0, 0);
+      return;
+    }
+    h = CreateThread(0, 5120000, threading::threadFunction, this, CREATE_SUSPENDED, 0);
+    DWORD_PTR mask = 0;
+    for (auto const c : cpus)
+      if (c < sizeof(DWORD_PTR) * 8) mask |= DWORD_PTR(1) << c;
+    if (mask) SetThreadAffinityMask(h, mask);
+    ResumeThread(h);
   }
 };
 
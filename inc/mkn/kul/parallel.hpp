@@ -0,0 +1,167 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_PARALLEL_HPP_
+#define MKN_KUL_PARALLEL_HPP_
+
+#include "mkn/kul/cpu.hpp"
+#include "mkn/kul/defs.hpp"
+#include "mkn/kul/span.hpp"
+#include "mkn/kul/threads.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <type_traits>
+
+namespace mkn::kul {
+namespace parallel {
+
+// shared pool used when none is given, one worker per hardware thread
+inline WorkStealingPool<>& pool() {
+  static WorkStealingPool<> p(std::max<std::size_t>(1, cpu::threads()), 1);
+  return p;
+}
+
+// chunk boundaries [0, ..., size], interior boundaries fall on cache line starts where T allows
+//  grain of 0 picks roughly four chunks per worker
+template <typename T>
+std::vector<std::size_t> chunks(T const* data, std::size_t const size, std::size_t grain,
+                                std::size_t const workers) {
+  constexpr std::size_t CL = MKN_KUL_CACHE_LINE_SIZE;
+  constexpr std::size_t per_line = sizeof(T) < CL ? CL / sizeof(T) : 1;
+  if (grain == 0) grain = size / (std::max<std::size_t>(1, workers) * 4);
+  grain = (std::max)(per_line, (grain + per_line - 1) / per_line * per_line);
+
+  std::size_t off = 0;
+  auto const addr = reinterpret_cast<std::uintptr_t>(data);
+  if (CL % sizeof(T) == 0 && addr % sizeof(T) == 0 && addr % CL)
+    off = (CL - addr % CL) / sizeof(T);
+
+  std::vector<std::size_t> bounds{0};
+  for (auto b = off + grain; b < size; b += grain) bounds.emplace_back(b);
+  bounds.emplace_back(size);
+  return bounds;
+}
+
+// runs fn(i) for i in [0, n) on the pool, the caller helps until all are done
+//  the first exception thrown by any fn is rethrown here
+template <typename E, typename Fn>
+void run(WorkStealingPool<E>& p, std::size_t const n, Fn&& fn) {
+  if (n == 0) return;
+  std::atomic<std::size_t> left{n};
+  std::exception_ptr ep;
+  std::mutex ep_m;
+  auto job = [&](std::size_t const i) {
+    try {
+      fn(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> l(ep_m);
+      if (!ep) ep = std::current_exception();
+    }
+    left.fetch_sub(1, std::memory_order_release);
+  };
+  for (std::size_t i = 1; i < n; ++i)
+    if (!p.async([&job, i]() { job(i); })) job(i);
+  job(0);
+  while (left.load(std::memory_order_acquire))
+    if (!p.help()) std::this_thread::yield();
+  if (ep) std::rethrow_exception(ep);
+}
+
+}  // namespace parallel
+
+// fn(T&) for every element, chunked across the pool
+template <typename E, typename T, typename SIZE, typename Fn>
+void parallel_for(WorkStealingPool<E>& pool, Span<T, SIZE> const& span, Fn&& fn,
+                  std::size_t const grain = 0) {
+  auto const bounds = parallel::chunks(span.data(), span.size(), grain, pool.size());
+  auto* const data = span.data();
+  parallel::run(pool, bounds.size() - 1, [&](std::size_t const c) {
+    for (auto i = bounds[c]; i < bounds[c + 1]; ++i) fn(data[i]);
+  });
+}
+template <typename T, typename SIZE, typename Fn>
+void parallel_for(Span<T, SIZE> const& span, Fn&& fn, std::size_t const grain = 0) {
+  parallel_for(parallel::pool(), span, std::forward<Fn>(fn), grain);
+}
+
+// fn(Span<T, SIZE>) for every sub-span, each sub-span is handled whole by one worker
+template <typename E, typename T, typename SIZE, typename Fn>
+void parallel_for(WorkStealingPool<E>& pool, SpanSet<T, SIZE>& set, Fn&& fn) {
+  parallel::run(pool, set.sizes().size(), [&](std::size_t const i) { fn(set[i]); });
+}
+template <typename T, typename SIZE, typename Fn>
+void parallel_for(SpanSet<T, SIZE>& set, Fn&& fn) {
+  parallel_for(parallel::pool(), set, std::forward<Fn>(fn));
+}
+
+// identity must leave any R unchanged under combine (e.g. 0 for +, 1 for *),
+//  each chunk is folded from a copy of it with op(R, T), chunk results are then
+//  folded in order onto another copy with combine(R, R)
+template <typename E, typename T, typename SIZE, typename R, typename Op, typename Combine>
+  requires(std::is_invocable_r_v<R, Op, R, T const&> && std::is_invocable_r_v<R, Combine, R, R>)
+R parallel_reduce(WorkStealingPool<E>& pool, Span<T, SIZE> const& span, R const identity, Op op,
+                  Combine combine, std::size_t const grain = 0) {
+  auto const bounds = parallel::chunks(span.data(), span.size(), grain, pool.size());
+  auto const* const data = span.data();
+  std::vector<R> partials(bounds.size() - 1, identity);
+  parallel::run(pool, partials.size(), [&](std::size_t const c) {
+    R acc = identity;
+    for (auto i = bounds[c]; i < bounds[c + 1]; ++i) acc = op(std::move(acc), data[i]);
+    partials[c] = std::move(acc);
+  });
+  R ret = identity;
+  for (auto& partial : partials) ret = combine(std::move(ret), std::move(partial));
+  return ret;
+}
+// op doubles as combine, so must also take (R, R), otherwise pass combine explicitly
+template <typename E, typename T, typename SIZE, typename R, typename Op>
+  requires(std::is_invocable_r_v<R, Op, R, R>)
+R parallel_reduce(WorkStealingPool<E>& pool, Span<T, SIZE> const& span, R const identity, Op op,
+                  std::size_t const grain = 0) {
+  return parallel_reduce(pool, span, identity, op, op, grain);
+}
+template <typename T, typename SIZE, typename R, typename Op>
+  requires(std::is_invocable_r_v<R, Op, R, R>)
+R parallel_reduce(Span<T, SIZE> const& span, R const identity, Op op,
+                  std::size_t const grain = 0) {
+  return parallel_reduce(parallel::pool(), span, identity, op, op, grain);
+}
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_PARALLEL_HPP_ */
@@ -0,0 +1,235 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MKN_KUL_QUEUE_HPP_
+#define MKN_KUL_QUEUE_HPP_
+
+#include "mkn/kul/defs.hpp"
+
+#include <new>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+
+namespace mkn::kul {
+
+// Bounded multi-producer/multi-consumer lock-free ring, each cell carries a sequence number
+//  so producers and consumers only contend on their own index. N must be a power of 2.
+template <typename T, std::size_t N>
+class MPMCQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "MPMCQueue size must be a power of 2");
+
+  struct Cell {
+    std::atomic<std::size_t> seq;
+    alignas(T) unsigned char data[sizeof(T)];
+
+    T* ptr() { return std::launder(reinterpret_cast<T*>(data)); }
+  };
+
+ public:
+  using value_type = T;
+
+  MPMCQueue() : _cells(new Cell[N]) {
+    for (std::size_t i = 0; i < N; ++i) _cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+  // no other thread may be using the queue
+  ~MPMCQueue() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      auto const h = _head.load(std::memory_order_acquire);
+      for (auto t = _tail.load(std::memory_order_acquire); t != h; ++t)
+        _cells[t & (N - 1)].ptr()->~T();
+    }
+  }
+
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    auto pos = _head.load(std::memory_order_relaxed);
+    Cell* c = nullptr;
+    for (;;) {
+      c = &_cells[pos & (N - 1)];
+      auto const seq = c->seq.load(std::memory_order_acquire);
+      auto const dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (dif == 0) {
+        if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (dif < 0)
+        return false;  // full
+      else
+        pos = _head.load(std::memory_order_relaxed);
+    }
+    ::new (c->data) T(std::forward<Args>(args)...);
+    c->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+  bool try_push(T const& t) { return try_emplace(t); }
+  bool try_push(T&& t) { return try_emplace(std::move(t)); }
+
+  bool try_pop(T& t) {
+    auto pos = _tail.load(std::memory_order_relaxed);
+    Cell* c = nullptr;
+    for (;;) {
+      c = &_cells[pos & (N - 1)];
+      auto const seq = c->seq.load(std::memory_order_acquire);
+      auto const dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (dif == 0) {
+        if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (dif < 0)
+        return false;  // empty
+      else
+        pos = _tail.load(std::memory_order_relaxed);
+    }
+    t = std::move(*c->ptr());
+    c->ptr()->~T();
+    c->seq.store(pos + N, std::memory_order_release);
+    return true;
+  }
+
+  // blocking variants spin briefly then yield until they succeed
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    for (std::size_t i = 0; !try_emplace(std::forward<Args>(args)...); ++i) backoff(i);
+  }
+  void push(T const& t) { emplace(t); }
+  void push(T&& t) { emplace(std::move(t)); }
+  void pop(T& t) {
+    for (std::size_t i = 0; !try_pop(t); ++i) backoff(i);
+  }
+
+  // approximate while other threads are pushing/popping
+  std::size_t size() const {
+    auto const h = _head.load(std::memory_order_acquire);
+    auto const t = _tail.load(std::memory_order_acquire);
+    return h > t ? h - t : 0;
+  }
+  bool empty() const { return size() == 0; }
+  static constexpr std::size_t capacity() { return N; }
+
+ private:
+  static void backoff(std::size_t const i) {
+    if (i < 64) return;
+    std::this_thread::yield();
+  }
+
+  std::unique_ptr<Cell[]> _cells;
+  alignas(MKN_KUL_CACHE_LINE_SIZE) std::atomic<std::size_t> _head{0};
+  alignas(MKN_KUL_CACHE_LINE_SIZE) std::atomic<std::size_t> _tail{0};
+
+  MPMCQueue(MPMCQueue const&) = delete;
+  MPMCQueue(MPMCQueue&&) = delete;
+  MPMCQueue& operator=(MPMCQueue const&) = delete;
+  MPMCQueue& operator=(MPMCQueue&&) = delete;
+};
+
+// Bounded single-producer/single-consumer ring of variable length byte records, N bytes total
+//  Records never wrap, if one does not fit before the end the rest of the buffer is skipped.
+//  N must be a power of 2, records are 8 byte aligned and carry an 8 byte header.
+template <std::size_t N>
+class SPSCRing {
+  static_assert(N >= 64 && (N & (N - 1)) == 0, "SPSCRing size must be a power of 2");
+  static constexpr std::uint32_t SKIP = 0xffffffff;
+  static constexpr std::size_t HEAD = 8;
+
+  static constexpr std::size_t round(std::size_t const n) { return (n + HEAD + 7) & ~std::size_t(7); }
+
+ public:
+  SPSCRing() : _buf(new unsigned char[N]) {}
+
+  // producer: writable space for a record of n bytes, or nullptr if the ring is too full
+  unsigned char* reserve(std::size_t const n) {
+    auto const need = round(n);
+    if (need > N) return nullptr;
+    auto const head = _head.load(std::memory_order_relaxed);
+    auto pos = head & (N - 1);
+    auto skip = N - pos < need ? N - pos : 0;
+    if (head + skip + need - _tail_cache > N) {
+      _tail_cache = _tail.load(std::memory_order_acquire);
+      if (head + skip + need - _tail_cache > N) return nullptr;
+    }
+    if ((_skip = skip)) {
+      std::uint32_t const m = SKIP;
+      std::memcpy(&_buf[pos], &m, sizeof(m));
+      pos = 0;
+    }
+    return &_buf[pos + HEAD];
+  }
+  // producer: publish the record last reserved with its final size, at most the reserved size
+  void commit(std::size_t const n) {
+    auto const head = _head.load(std::memory_order_relaxed) + _skip;
+    std::uint32_t const m = static_cast<std::uint32_t>(n);
+    std::memcpy(&_buf[head & (N - 1)], &m, sizeof(m));
+    _skip = 0;
+    _head.store(head + round(n), std::memory_order_release);
+  }
+
+  // consumer: f(unsigned char const*, std::size_t) for every published record, returns the count
+  template <typename F>
+  std::size_t drain(F&& f) {
+    auto tail = _tail.load(std::memory_order_relaxed);
+    auto const head = _head.load(std::memory_order_acquire);
+    std::size_t c = 0;
+    while (tail < head) {
+      auto const pos = tail & (N - 1);
+      std::uint32_t m;
+      std::memcpy(&m, &_buf[pos], sizeof(m));
+      if (m == SKIP) {
+        tail += N - pos;
+        continue;
+      }
+      f(static_cast<unsigned char const*>(&_buf[pos + HEAD]), std::size_t{m});
+      tail += round(m);
+      ++c;
+    }
+    _tail.store(tail, std::memory_order_release);
+    return c;
+  }
+
+  bool empty() const {
+    return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+  }
+  static constexpr std::size_t capacity() { return N; }
+
+ private:
+  std::unique_ptr<unsigned char[]> _buf;
+  alignas(MKN_KUL_CACHE_LINE_SIZE) std::atomic<std::size_t> _head{0};
+  std::size_t _tail_cache = 0, _skip = 0;  // producer only
+  alignas(MKN_KUL_CACHE_LINE_SIZE) std::atomic<std::size_t> _tail{0};
+
+  SPSCRing(SPSCRing const&) = delete;
+  SPSCRing(SPSCRing&&) = delete;
+  SPSCRing& operator=(SPSCRing const&) = delete;
+  SPSCRing& operator=(SPSCRing&&) = delete;
+};
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_QUEUE_HPP_ */
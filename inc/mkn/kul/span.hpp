@@ -104,7 +104,7 @@ struct SpanSet {
         m_sizes(sizes_),
         m_displs(sizes_.size()),
         m_vec(m_size) {
-    for (SIZE off = 0, i = 0; i < static_cast<SIZE>(sizes_.size()); i++, off += sizes_[i])
+    for (SIZE off = 0, i = 0; i < static_cast<SIZE>(sizes_.size()); off += sizes_[i++])
       m_displs[i] = off;
   }
 
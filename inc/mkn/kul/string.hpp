@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "mkn/kul/except.hpp"
 
+#include <array>
 #include <cmath>
 #include <cctype>
 #include <cerrno>
@@ -41,9 +42,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
 #include <optional>
 #include <sstream>
 #include <utility>
+#include <string_view>
+#include <initializer_list>
 #include <algorithm>
 #include <unordered_map>
 
@@ -52,6 +56,16 @@ namespace kul {
 
 enum STR_INT_RET { IS_SUCCESS = 0, IS_OVERFLOW, IS_UNDERFLOW, IS_INCONVERTIBLE };
 
+}  // namespace kul
+}  // namespace mkn
+
+#include "mkn/kul/string/num.hpp"
+#include "mkn/kul/string/ascii.hpp"
+#include "mkn/kul/string/builder.hpp"
+
+namespace mkn {
+namespace kul {
+
 struct Between {
   std::string remaining;
   std::optional<std::string> found;
@@ -64,6 +78,118 @@ class StringException : public mkn::kul::Exception {
       : mkn::kul::Exception(f, l, s) {}
 };
 
+// Lazy range over the pieces of s between delimiters, each a view into s so nothing is copied
+//  and s must outlive the range. Empty pieces are skipped unless keep_empty. With an escape
+//  character a delimiter directly after it does not split, both stay in the piece.
+class SplitView {
+ public:
+  SplitView(std::string_view const s, char const d, bool const keep_empty = false,
+            std::optional<char> const esc = std::nullopt)
+      : _s(s), _c(d), _one(true), _keep(keep_empty), _esc(esc) {}
+  // d must outlive the range too, an empty d yields s whole
+  SplitView(std::string_view const s, std::string_view const d, bool const keep_empty = false,
+            std::optional<char> const esc = std::nullopt)
+      : _s(s), _d(d), _keep(keep_empty), _esc(esc) {}
+
+  class iterator {
+    friend class SplitView;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::string_view;
+
+    iterator() = default;
+
+    std::string_view operator*() const { return _v->piece(_b, _e); }
+    iterator& operator++() {
+      _v->seek(_b, _e, _e + _v->width());
+      return *this;
+    }
+    iterator operator++(int) {
+      auto i = *this;
+      ++*this;
+      return i;
+    }
+    bool operator==(iterator const& i) const { return _b == i._b; }
+    bool operator!=(iterator const& i) const { return _b != i._b; }
+
+   private:
+    iterator(SplitView const* v, std::size_t const b, std::size_t const e) : _v(v), _b(b), _e(e) {}
+
+    SplitView const* _v = nullptr;
+    std::size_t _b = std::string_view::npos, _e = std::string_view::npos;
+  };
+
+  iterator begin() const {
+    iterator i(this, 0, 0);
+    seek(i._b, i._e, 0);
+    return i;
+  }
+  iterator end() const { return iterator(this, std::string_view::npos, std::string_view::npos); }
+
+  // appends every piece to v, eg a reused std::vector<std::string_view>
+  template <typename V>
+  V& into(V& v) const {
+    for (auto const p : *this) v.emplace_back(p);
+    return v;
+  }
+
+ private:
+  friend SplitView lines_view(std::string_view, bool);
+
+  // steps past the end of _s for an empty _d, whose only piece is the whole of _s
+  std::size_t width() const { return _one || _d.empty() ? 1 : _d.size(); }
+  // next unescaped delimiter at or after p, or the end of _s
+  std::size_t find(std::size_t p) const {
+    if (!_one && _d.empty()) return _s.size();
+    for (;; ++p) {
+      p = _one ? _s.find(_c, p) : _s.find(_d, p);
+      if (p == std::string_view::npos) return _s.size();
+      if (!_esc || p == 0 || _s[p - 1] != *_esc) return p;
+    }
+  }
+  // the first piece wanted starting at p, b is npos past the last one
+  void seek(std::size_t& b, std::size_t& e, std::size_t p) const {
+    for (; p <= _s.size(); p = e + width()) {
+      b = p, e = find(p);
+      if (_keep || piece(b, e).size()) return;
+      if (e == _s.size()) break;
+    }
+    b = e = std::string_view::npos;
+  }
+  std::string_view piece(std::size_t const b, std::size_t e) const {
+    if (_cr && e > b && _s[e - 1] == '\r') --e;
+    return _s.substr(b, e - b);
+  }
+
+  std::string_view _s, _d;
+  char _c = 0;
+  bool _one = false, _keep = false, _cr = false;
+  std::optional<char> _esc;
+};
+
+inline SplitView split_view(std::string_view const s, char const d, bool const keep_empty = false) {
+  return SplitView(s, d, keep_empty);
+}
+inline SplitView split_view(std::string_view const s, std::string_view const d,
+                            bool const keep_empty = false) {
+  return SplitView(s, d, keep_empty);
+}
+// keeps empty pieces like String::ESC_SPLIT, escape characters are left in the views
+inline SplitView esc_split_view(std::string_view const s, char const d, char const e = '\\',
+                                bool const keep_empty = true) {
+  return SplitView(s, d, keep_empty, e);
+}
+// lines split on \n with a trailing \r dropped
+inline SplitView lines_view(std::string_view const s, bool const keep_empty = false) {
+  SplitView v(s, '\n', keep_empty);
+  v._cr = true;
+  return v;
+}
+
 class String;
 class StringOpHelper {
   friend class String;
@@ -91,23 +217,76 @@ class String {
     size_t p = 0;
     if ((p = s.find(f)) != std::string::npos) s.replace(p, f.size(), r);
   }
-  static void REPLACE_ALL(std::string& s, std::string const& f, std::string const& r) {
-    size_t p = s.find(f);
-    while (p != std::string::npos) {
-      s.replace(s.find(f, p), f.size(), r);
-      p = s.find(f, p + r.size());
+  // replacements are not rescanned, an empty f does nothing
+  static void REPLACE_ALL(std::string& s, std::string_view const f, std::string_view const r) {
+    auto p = f.empty() ? std::string::npos : s.find(f);
+    if (p == std::string::npos) return;
+    if (f.size() == r.size()) {
+      for (; p != std::string::npos; p = s.find(f, p + f.size())) s.replace(p, f.size(), r);
+      return;
+    }
+    std::string o;
+    o.reserve(s.size() + (r.size() > f.size() ? s.size() / 8 : 0));
+    std::size_t b = 0;
+    for (; p != std::string::npos; p = s.find(f, b)) {
+      o.append(s, b, p - b).append(r);
+      b = p + f.size();
     }
+    o.append(s, b);
+    s = std::move(o);
+  }
+  // every pattern replaced in one pass, at each position the longest matching pattern wins and
+  //  replacements are not rescanned, eg {{"&", "&amp;"}, {"<", "&lt;"}}
+  using Replacement = std::pair<std::string_view, std::string_view>;
+  static void REPLACE_MANY(std::string& s, std::initializer_list<Replacement> const ps) {
+    REPLACE_MANY(s, ps.begin(), ps.end());
+  }
+  static void REPLACE_MANY(std::string& s, std::vector<Replacement> const& ps) {
+    REPLACE_MANY(s, ps.data(), ps.data() + ps.size());
+  }
+  template <typename It>
+  static void REPLACE_MANY(std::string& s, It const begin, It const end) {
+    // patterns indexed by first byte, longest first
+    std::array<std::vector<Replacement>, 256> by;
+    for (auto it = begin; it != end; ++it)
+      if (!it->first.empty()) by[static_cast<unsigned char>(it->first[0])].emplace_back(*it);
+    for (auto& v : by)
+      std::stable_sort(v.begin(), v.end(), [](auto const& a, auto const& b) {
+        return a.first.size() > b.first.size();
+      });
+
+    std::string_view const in(s);
+    std::string o;
+    std::size_t b = 0;
+    bool hit = false;
+    for (std::size_t i = 0; i < in.size();) {
+      auto const& v = by[static_cast<unsigned char>(in[i])];
+      auto const m = std::find_if(v.begin(), v.end(), [&](auto const& p) {
+        return in.compare(i, p.first.size(), p.first) == 0;
+      });
+      if (m == v.end()) {
+        ++i;
+        continue;
+      }
+      if (!hit) o.reserve(s.size() + s.size() / 8), hit = true;
+      o.append(in.substr(b, i - b)).append(m->second);
+      b = i += m->first.size();
+    }
+    if (!hit) return;
+    o.append(in.substr(b));
+    s = std::move(o);
   }
   static void TRIM_LEFT(std::string& s, char const& delim = ' ') {
-    while (s.find(delim) == 0) s.erase(0, 1);
+    s.erase(0, (std::min)(s.find_first_not_of(delim), s.size()));
   }
   static void TRIM_RIGHT(std::string& s, char const& delim = ' ') {
-    while (s.rfind(delim) == s.size() - 1) s.pop_back();
+    s.erase(s.find_last_not_of(delim) + 1);
   }
+  // ' ' and '\t' either side
   static void TRIM(std::string& s) {
-    while (s.find(' ') == 0 || s.find('\t') == 0) s.erase(0, 1);
-    if (s.size() == 0) return;
-    while (s.rfind(' ') == s.size() - 1 || s.rfind('\t') == s.size() - 1) s.pop_back();
+    auto const v = ascii::trim(s);
+    s.erase(static_cast<std::size_t>(v.data() - s.data()) + v.size());
+    s.erase(0, static_cast<std::size_t>(v.data() - s.data()));
   }
 
   template <typename V>
@@ -124,12 +303,15 @@ class String {
     return v;
   }
   static void SPLIT(std::string const& s, char const& d, std::vector<std::string>& v) {
-    if (s.find(d) != std::string::npos) {
-      std::string l;
-      std::stringstream stream(s);
-      while (std::getline(stream, l, d))
-        if (l.compare("") != 0) v.push_back(l);
-    } else
+    if (s.find(d) != std::string::npos)
+      split_view(s, d).into(v);
+    else
+      v.push_back(s);
+  }
+  static void SPLIT(std::string_view const s, char const d, std::vector<std::string_view>& v) {
+    if (s.find(d) != std::string_view::npos)
+      split_view(s, d).into(v);
+    else
       v.push_back(s);
   }
   static std::vector<std::string> SPLIT(std::string const& s, std::string const& d) {
@@ -137,14 +319,12 @@ class String {
     SPLIT(s, d, v);
     return v;
   }
+  // the search resumes one past the start of each match, not past the whole delimiter
   static void SPLIT(std::string const& s, std::string const& d, std::vector<std::string>& v) {
-    std::string l = s;
-    size_t pos = 0;
-    while ((pos = l.find(d)) != std::string::npos) {
-      v.push_back(l.substr(0, pos));
-      l = l.substr(pos + 1);
-    }
-    v.push_back(l);
+    std::size_t b = 0;
+    for (auto p = s.find(d); p != std::string::npos; p = s.find(d, b = p + 1))
+      v.emplace_back(s, b, p - b);
+    v.emplace_back(s, b);
   }
   static std::vector<std::string> ESC_SPLIT(std::string const& s, char const& d,
                                             char const& e = '\\') {
@@ -152,32 +332,18 @@ class String {
     ESC_SPLIT(s, d, v, e);
     return v;
   }
+  // every escape character is removed from the pieces
   static void ESC_SPLIT(std::string const& s, char const& d, std::vector<std::string>& v,
                         char const& e = '\\') {
-    std::string l = s, es = std::string(1, e);
-    std::string tmp = l;
-    size_t pos = 0, esc = 0;
-    while ((pos = l.find(d, esc)) != std::string::npos) {
-      if (pos && l[pos - 1] == e) {
-        esc = pos + 1;
-        tmp = l.substr(esc);
-        continue;
-      }
-      if (tmp.find(d, esc) == std::string::npos) break;
-      std::string t = l.substr(0, pos);
-      REPLACE_ALL(t, es, "");
-      v.push_back(t);
-      l = l.substr(pos + 1);
-      esc = 0;
-      tmp = l;
+    for (auto const p : esc_split_view(s, d, e)) {
+      auto& t = v.emplace_back();
+      t.reserve(p.size());
+      for (auto const c : p)
+        if (c != e) t += c;
     }
-    REPLACE_ALL(l, es, "");
-    v.push_back(l);
   }
-  static bool NO_CASE_CMP(std::string a, std::string b) {
-    std::transform(a.begin(), a.end(), a.begin(), ::tolower);
-    std::transform(b.begin(), b.end(), b.begin(), ::tolower);
-    return (a == b);
+  static bool NO_CASE_CMP(std::string_view const a, std::string_view const b) {
+    return ascii::iequals(a, b);
   }
   static Between BETWEEN(std::string const& in, std::string lstr, std::string rstr) {
     Between ret{in, {}, 0};
@@ -202,138 +368,61 @@ class String {
     return v;
   }
   static void LINES(std::string const& s, std::vector<std::string>& v) {
-    if (s.find("\n") != std::string::npos) {
-      std::string l;
-      std::stringstream ss(s);
-      while (std::getline(ss, l))
-        if (!l.empty()) v.push_back(l);
-    } else
+    if (s.find('\n') != std::string::npos)
+      split_view(s, '\n').into(v);
+    else
+      v.push_back(s);
+  }
+  static void LINES(std::string_view const s, std::vector<std::string_view>& v) {
+    if (s.find('\n') != std::string_view::npos)
+      split_view(s, '\n').into(v);
+    else
       v.push_back(s);
   }
 
-  static bool BOOL(std::string s) {
-    TRIM(s);
-    std::vector<std::string> const& pos{"yes", "y", "true", "1"};
-    std::vector<std::string> const& neg{"no", "n", "false", "0"};
-    std::transform(s.begin(), s.end(), s.begin(), ::tolower);
-    if (std::find(pos.begin(), pos.end(), s) != pos.end()) return true;
-    if (std::find(neg.begin(), neg.end(), s) != neg.end()) return false;
-    KEXCEPT(StringException, "input not bool-able, " + s);
-  }
-
-  static uint16_t UINT16(std::string const& str) KTHROW(StringException) {
-    auto lambda = [](char const* s, uint32_t& lresult) {
-      char* end;
-      errno = 0;
-      lresult = strtoul(s, &end, 10);
-      if ((errno == ERANGE) || lresult > UINT16_MAX) return IS_OVERFLOW;
-      if (*s == '\0' || *end != '\0') return IS_INCONVERTIBLE;
-      return IS_SUCCESS;
-    };
-    uint32_t lresult = 0;
-    STR_INT_RET ret = lambda(str.c_str(), lresult);
-    if (ret != IS_SUCCESS)
-      KEXCEPT(StringException,
-              "UINT16 conversion failed, reason: " + StringOpHelper::INSTANCE().getStrForRet(ret));
-    uint16_t result = lresult;
-    if (result != lresult) KEXCEPT(StringException, "UINT16 conversion failed");
-    return result;
-  }
-  static int16_t INT16(std::string const& str) KTHROW(StringException) {
-    auto lambda = [](char const* s, int32_t& lresult) {
-      char* end;
-      errno = 0;
-      lresult = strtol(s, &end, 10);
-      if ((errno == ERANGE) || lresult > INT16_MAX) return IS_OVERFLOW;
-      if ((errno == ERANGE) || lresult < INT16_MIN) return IS_UNDERFLOW;
-      if (*s == '\0' || *end != '\0') return IS_INCONVERTIBLE;
-      return IS_SUCCESS;
-    };
-    int32_t lresult = 0;
-    STR_INT_RET ret = lambda(str.c_str(), lresult);
-    if (ret != IS_SUCCESS)
-      KEXCEPT(StringException,
-              "INT16 conversion failed, reason: " + StringOpHelper::INSTANCE().getStrForRet(ret));
-    int16_t result = lresult;
-    if (result != lresult) KEXCEPT(StringException, "INT16 conversion failed");
-    return result;
-  }
-
-  static uint32_t UINT32(std::string const& str) KTHROW(StringException) {
-    auto lambda = [](char const* s, uint64_t& lresult) {
-      char* end;
-      errno = 0;
-      lresult = strtoull(s, &end, 10);
-      if ((errno == ERANGE) || lresult > UINT32_MAX) return IS_OVERFLOW;
-      if (*s == '\0' || *end != '\0') return IS_INCONVERTIBLE;
-      return IS_SUCCESS;
-    };
-    uint64_t lresult = 0;
-    STR_INT_RET ret = lambda(str.c_str(), lresult);
-    if (ret != IS_SUCCESS)
-      KEXCEPT(StringException,
-              "UINT32 conversion failed, reason: " + StringOpHelper::INSTANCE().getStrForRet(ret));
-    uint32_t result = lresult;
-    if (result != lresult) KEXCEPT(StringException, "UINT32 conversion failed");
-    return result;
-  }
-  static int32_t INT32(std::string const& str) KTHROW(StringException) {
-    auto lambda = [](char const* s, int64_t& lresult) {
-      char* end;
-      errno = 0;
-      lresult = strtoll(s, &end, 10);
-      if ((errno == ERANGE) || lresult > INT32_MAX) return IS_OVERFLOW;
-      if ((errno == ERANGE) || lresult < INT32_MIN) return IS_UNDERFLOW;
-      if (*s == '\0' || *end != '\0') return IS_INCONVERTIBLE;
-      return IS_SUCCESS;
-    };
-    int64_t lresult = 0;
-    STR_INT_RET ret = lambda(str.c_str(), lresult);
-    if (ret != IS_SUCCESS)
-      KEXCEPT(StringException,
-              "INT32 conversion failed, reason: " + StringOpHelper::INSTANCE().getStrForRet(ret));
-    int32_t result = lresult;
-    if (result != lresult) KEXCEPT(StringException, "INT32 conversion failed");
-    return result;
-  }
-
-  static uint64_t UINT64(std::string const& str) KTHROW(StringException) {
-    auto lambda = [](char const* s, uint64_t& lresult) {
-      char* end;
-      errno = 0;
-      lresult = strtoull(s, &end, 10);
-      if ((errno == ERANGE) || lresult > UINT64_MAX) return IS_OVERFLOW;
-      if (*s == '\0' || *end != '\0') return IS_INCONVERTIBLE;
-      return IS_SUCCESS;
-    };
-    uint64_t lresult = 0;
-    STR_INT_RET ret = lambda(str.c_str(), lresult);
-    if (ret != IS_SUCCESS)
-      KEXCEPT(StringException,
-              "UINT64 conversion failed, reason: " + StringOpHelper::INSTANCE().getStrForRet(ret));
-    uint64_t result = lresult;
-    if (result != lresult) KEXCEPT(StringException, "UINT64 conversion failed");
-    return result;
-  }
-
-  static int64_t INT64(std::string const& str) KTHROW(StringException) {
-    auto lambda = [](char const* s, int64_t& lresult) {
-      char* end;
-      errno = 0;
-      lresult = strtoll(s, &end, 10);
-      if ((errno == ERANGE) || lresult > INT64_MAX) return IS_OVERFLOW;
-      if ((errno == ERANGE) || lresult < 0) return IS_UNDERFLOW;
-      if (*s == '\0' || *end != '\0') return IS_INCONVERTIBLE;
-      return IS_SUCCESS;
-    };
-    int64_t lresult = 0;
-    STR_INT_RET ret = lambda(str.c_str(), lresult);
-    if (ret != IS_SUCCESS)
-      KEXCEPT(StringException,
-              "INT64 conversion failed, reason: " + StringOpHelper::INSTANCE().getStrForRet(ret));
-    int64_t result = lresult;
-    if (result != lresult) KEXCEPT(StringException, "INT64 conversion failed");
-    return result;
+  static bool BOOL(std::string_view const s) {
+    auto const v = ascii::trim(s);
+    for (auto const p : {"yes", "y", "true", "1"})
+      if (ascii::iequals(v, p)) return true;
+    for (auto const n : {"no", "n", "false", "0"})
+      if (ascii::iequals(v, n)) return false;
+    std::string l(v);
+    KEXCEPT(StringException, "input not bool-able, " + ascii::lower(l));
+  }
+
+  // leading whitespace and '+' are accepted as with strtol, throws with the STR_INT_RET reason
+  static uint16_t UINT16(std::string_view const str) KTHROW(StringException) {
+    return NUMBER<uint16_t>("UINT16", str);
+  }
+  static int16_t INT16(std::string_view const str) KTHROW(StringException) {
+    return NUMBER<int16_t>("INT16", str);
+  }
+  static uint32_t UINT32(std::string_view const str) KTHROW(StringException) {
+    return NUMBER<uint32_t>("UINT32", str);
+  }
+  static int32_t INT32(std::string_view const str) KTHROW(StringException) {
+    return NUMBER<int32_t>("INT32", str);
+  }
+  static uint64_t UINT64(std::string_view const str) KTHROW(StringException) {
+    return NUMBER<uint64_t>("UINT64", str);
+  }
+  // negative input is reported as UNDERFLOW
+  static int64_t INT64(std::string_view const str) KTHROW(StringException) {
+    return NUMBER<int64_t>("INT64", str);
+  }
+
+ private:
+  template <typename T>
+  static T NUMBER(char const* const name, std::string_view s) KTHROW(StringException) {
+    while (s.size() && std::isspace(static_cast<unsigned char>(s[0]))) s.remove_prefix(1);
+    if (s.size() > 1 && s[0] == '+' && s[1] != '-') s.remove_prefix(1);
+    auto r = parse<T>(s);
+    if constexpr (std::is_same_v<T, int64_t>)
+      if (r && *r < 0) r.ret = IS_UNDERFLOW;
+    if (!r)
+      KEXCEPT(StringException, std::string(name) + " conversion failed, reason: " +
+                                   StringOpHelper::INSTANCE().getStrForRet(r.ret));
+    return *r;
   }
 };
 }  // namespace kul
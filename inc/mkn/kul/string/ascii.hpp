@@ -0,0 +1,208 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/string.hpp"
+
+#ifndef MKN_KUL_STRING_ASCII_HPP_
+#define MKN_KUL_STRING_ASCII_HPP_
+
+#include <bit>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if !defined(MKN_KUL_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MKN_KUL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifndef MKN_KUL_SSE2
+#define MKN_KUL_SSE2 0
+#endif
+
+// ASCII only kernels, bytes outside 'A'-'Z'/'a'-'z' are never changed so UTF-8 passes through.
+//  SSE2 handles 16 bytes at a time where available, else 8 at a time within a uint64_t.
+namespace mkn::kul::ascii {
+namespace detail {
+
+inline std::uint64_t load8(char const* const p) {
+  std::uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+// 0x20 in every byte of v that is an ASCII letter in [lo, lo + 26)
+inline std::uint64_t case8(std::uint64_t const v, char const lo) {
+  constexpr std::uint64_t ONES = 0x0101010101010101, HIGH = 0x8080808080808080;
+  auto const low = v & ~HIGH;
+  auto const ge = low + ONES * (0x80 - static_cast<std::uint64_t>(lo));
+  auto const gt = low + ONES * (0x80 - static_cast<std::uint64_t>(lo) - 26);
+  return ((~v & HIGH) & (ge ^ gt)) >> 2;
+}
+inline char fold(char const c) { return c >= 'A' && c <= 'Z' ? char(c | 0x20) : c; }
+
+#if MKN_KUL_SSE2
+inline __m128i case16(__m128i const v, char const lo) {
+  auto const t = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(lo + 128)));
+  return _mm_and_si128(_mm_cmplt_epi8(t, _mm_set1_epi8(-128 + 26)), _mm_set1_epi8(0x20));
+}
+// bit i set where byte i is ' ' or '\t', or any of " \t\n\v\f\r" with space
+inline int blank16(__m128i const v, bool const space) {
+  auto m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                        _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+  if (space)  // '\t'..'\r' is 9..13
+    m = _mm_or_si128(m, _mm_cmplt_epi8(_mm_sub_epi8(v, _mm_set1_epi8(9 - 128)),
+                                       _mm_set1_epi8(-128 + 5)));
+  return _mm_movemask_epi8(m);
+}
+#endif
+
+inline void flip(char* p, std::size_t n, char const lo) {
+#if MKN_KUL_SSE2
+  for (; n >= 16; p += 16, n -= 16) {
+    auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_xor_si128(v, case16(v, lo)));
+  }
+#endif
+  for (; n >= 8; p += 8, n -= 8) {
+    auto const v = load8(p);
+    auto const r = v ^ case8(v, lo);
+    std::memcpy(p, &r, 8);
+  }
+  for (; n; ++p, --n)
+    if (*p >= lo && *p < lo + 26) *p ^= 0x20;
+}
+
+inline bool is_blank(char const c, bool const space) {
+  return c == ' ' || c == '\t' || (space && c >= '\n' && c <= '\r');
+}
+inline std::string_view trim(std::string_view const s, bool const space) {
+  auto const* b = s.data();
+  auto const* e = b + s.size();
+#if MKN_KUL_SSE2
+  for (; e - b >= 16; b += 16) {
+    auto const m = blank16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(b)), space);
+    if (m != 0xFFFF) {
+      b += std::countr_zero(static_cast<unsigned>(~m));
+      break;
+    }
+  }
+#endif
+  while (b != e && is_blank(*b, space)) ++b;
+#if MKN_KUL_SSE2
+  for (; e - b >= 16; e -= 16) {
+    auto const m = blank16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(e - 16)), space);
+    if (m != 0xFFFF) {
+      e -= std::countl_zero(static_cast<std::uint32_t>(~m & 0xFFFF)) - 16;
+      break;
+    }
+  }
+#endif
+  while (e != b && is_blank(e[-1], space)) --e;
+  return std::string_view(b, static_cast<std::size_t>(e - b));
+}
+
+}  // namespace detail
+
+inline void lower(char* const p, std::size_t const n) { detail::flip(p, n, 'A'); }
+inline void upper(char* const p, std::size_t const n) { detail::flip(p, n, 'a'); }
+inline std::string& lower(std::string& s) {
+  lower(s.data(), s.size());
+  return s;
+}
+inline std::string& upper(std::string& s) {
+  upper(s.data(), s.size());
+  return s;
+}
+
+// without ' ' and '\t' either side, or any of " \t\n\v\f\r" with space
+inline std::string_view trim(std::string_view const s, bool const space = false) {
+  return detail::trim(s, space);
+}
+
+inline bool iequals(std::string_view const a, std::string_view const b) {
+  if (a.size() != b.size()) return false;
+  auto const* x = a.data();
+  auto const* y = b.data();
+  auto n = a.size();
+#if MKN_KUL_SSE2
+  for (; n >= 16; x += 16, y += 16, n -= 16) {
+    auto const u = _mm_loadu_si128(reinterpret_cast<__m128i const*>(x));
+    auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(y));
+    auto const eq = _mm_cmpeq_epi8(_mm_or_si128(u, detail::case16(u, 'A')),
+                                   _mm_or_si128(v, detail::case16(v, 'A')));
+    if (_mm_movemask_epi8(eq) != 0xFFFF) return false;
+  }
+#endif
+  for (; n >= 8; x += 8, y += 8, n -= 8) {
+    auto const u = detail::load8(x), v = detail::load8(y);
+    if ((u | detail::case8(u, 'A')) != (v | detail::case8(v, 'A'))) return false;
+  }
+  for (; n; ++x, ++y, --n)
+    if (detail::fold(*x) != detail::fold(*y)) return false;
+  return true;
+}
+
+// equal for strings iequals finds equal, eg for case insensitive unordered_map keys
+inline std::uint64_t ihash(std::string_view const s) {
+  constexpr std::uint64_t K = 0x9E3779B97F4A7C15;
+  std::uint64_t h = s.size() * K;
+  auto const* p = s.data();
+  auto n = s.size();
+  for (; n >= 8; p += 8, n -= 8) {
+    auto const v = detail::load8(p);
+    h = (h ^ (v | detail::case8(v, 'A'))) * K;
+    h ^= h >> 29;
+  }
+  if (n) {
+    std::uint64_t v = 0;
+    std::memcpy(&v, p, n);
+    h = (h ^ (v | detail::case8(v, 'A'))) * K;
+  }
+  h ^= h >> 32;
+  h *= 0xD6E8FEB86659FD93;
+  return h ^ (h >> 32);
+}
+
+struct IHash {
+  std::size_t operator()(std::string_view const s) const {
+    return static_cast<std::size_t>(ihash(s));
+  }
+};
+struct IEquals {
+  bool operator()(std::string_view const a, std::string_view const b) const {
+    return iequals(a, b);
+  }
+};
+
+}  // namespace mkn::kul::ascii
+
+#endif /* MKN_KUL_STRING_ASCII_HPP_ */
@@ -0,0 +1,166 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/string.hpp"
+
+#ifndef MKN_KUL_STRING_BUILDER_HPP_
+#define MKN_KUL_STRING_BUILDER_HPP_
+
+#include "mkn/kul/alloc/arena.hpp"
+
+#include <string>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+
+// chars held inside a StringBuilder before it needs the heap or its arena
+#ifndef MKN_KUL_STRING_BUILDER_INLINE
+#define MKN_KUL_STRING_BUILDER_INLINE 256
+#endif
+
+namespace mkn::kul {
+namespace builder {
+
+template <typename T>
+constexpr bool is_char_v =
+    std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>;
+
+// what std::to_chars takes, wide character types are not numbers here
+template <typename T>
+constexpr bool is_number_v =
+    std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !is_char_v<T> &&
+    !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> && !std::is_same_v<T, char16_t> &&
+    !std::is_same_v<T, char32_t>;
+
+}  // namespace builder
+
+// Appends into N inline chars, then into a buffer doubled on the heap, or taken from the arena if
+//  one is given, whenever it fills. Numbers are written with std::to_chars, bools as 1/0 and the
+//  char types as a char, as an std::ostream would. view() is invalidated by the next append.
+template <std::size_t N = MKN_KUL_STRING_BUILDER_INLINE>
+class StringBuilder {
+ public:
+  template <typename T>
+  static constexpr bool appendable =
+      std::is_same_v<T, bool> || builder::is_char_v<T> || builder::is_number_v<T> ||
+      std::is_convertible_v<T const&, std::string_view>;
+
+  StringBuilder() = default;
+  StringBuilder(Arena& a) : _a(&a) {}
+  ~StringBuilder() { release(); }
+
+  template <typename T>
+    requires(appendable<T>)
+  StringBuilder& append(T const& t) {
+    if constexpr (std::is_same_v<T, bool>)
+      *grow(1) = t ? '1' : '0', ++_n;
+    else if constexpr (builder::is_char_v<T>)
+      *grow(1) = static_cast<char>(t), ++_n;
+    else if constexpr (builder::is_number_v<T>) {
+      constexpr std::size_t MAX = 64;  // shortest round trip form of any of them fits
+      auto* p = grow(MAX);
+      _n = std::to_chars(p, p + MAX, t).ptr - _p;
+    } else if constexpr (std::is_convertible_v<T const&, char const*>) {
+      if (char const* s = t) write(s, std::strlen(s));
+    } else {
+      std::string_view const s(t);
+      write(s.data(), s.size());
+    }
+    return *this;
+  }
+  // as printf("%.*g", precision, t)
+  template <typename T>
+    requires(std::is_floating_point_v<T>)
+  StringBuilder& append(T const t, int const precision) {
+    auto const max = std::size_t{32} + static_cast<std::size_t>((std::max)(precision, 0));
+    auto* p = grow(max);
+    _n = std::to_chars(p, p + max, t, std::chars_format::general, precision).ptr - _p;
+    return *this;
+  }
+  StringBuilder& append(std::size_t const n, char const c) {
+    std::memset(grow(n), c, n);
+    _n += n;
+    return *this;
+  }
+
+  template <typename T>
+  StringBuilder& operator<<(T const& t) {
+    return append(t);
+  }
+
+  std::string_view view() const { return {_p, _n}; }
+  std::string str() const { return {_p, _n}; }
+  char const* data() const { return _p; }
+  std::size_t size() const { return _n; }
+  std::size_t capacity() const { return _cap; }
+  bool empty() const { return _n == 0; }
+  char back() const { return _p[_n - 1]; }
+  void pop_back() { --_n; }
+  // keeps the current buffer
+  void clear() { _n = 0; }
+
+  void reserve(std::size_t const c) {
+    if (c <= _cap) return;
+    auto* p = _a ? static_cast<char*>(_a->allocate(c, 1)) : new char[c];
+    std::memcpy(p, _p, _n);
+    release();
+    _p = p, _cap = c;
+  }
+
+ private:
+  // room for k more chars, at the end
+  char* grow(std::size_t const k) {
+    if (_n + k > _cap) reserve((std::max)(_cap * 2, _n + k));
+    return _p + _n;
+  }
+  void write(char const* const s, std::size_t const k) {
+    if (k) std::memcpy(grow(k), s, k);
+    _n += k;
+  }
+  void release() {
+    if (_p != _in && !_a) delete[] _p;
+  }
+
+  char _in[N];
+  char* _p = _in;
+  std::size_t _n = 0, _cap = N;
+  Arena* _a = nullptr;
+
+  StringBuilder(StringBuilder const&) = delete;
+  StringBuilder(StringBuilder&&) = delete;
+  StringBuilder& operator=(StringBuilder const&) = delete;
+  StringBuilder& operator=(StringBuilder&&) = delete;
+};
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_STRING_BUILDER_HPP_ */
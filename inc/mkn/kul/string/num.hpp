@@ -0,0 +1,166 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/string.hpp"
+
+#ifndef MKN_KUL_STRING_NUM_HPP_
+#define MKN_KUL_STRING_NUM_HPP_
+
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <limits>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+namespace mkn::kul {
+
+// a parsed number or why there is none, ret is the reason when false
+template <typename T>
+struct Parsed {
+  T value{};
+  STR_INT_RET ret = IS_INCONVERTIBLE;
+
+  explicit operator bool() const { return ret == IS_SUCCESS; }
+  T const& operator*() const { return value; }
+};
+
+namespace number {
+
+// eight ASCII digits loaded little endian, checked and combined without a loop
+inline bool digits8(std::uint64_t const v) {
+  return (((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+          0x3333333333333333);
+}
+inline std::uint64_t value8(std::uint64_t v) {
+  v -= 0x3030303030303030;
+  v = (v * 10) + (v >> 8);
+  return (((v & 0x000000FF000000FF) * 0x000F424000000064) +
+          (((v >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >>
+         32;
+}
+
+// the unsigned magnitude of the digit run at the start of s, n is how many digits were read
+inline STR_INT_RET magnitude(std::string_view const s, std::uint64_t& m, std::size_t& n) {
+  m = 0, n = 0;
+  auto const* p = s.data();
+  auto const* const e = p + s.size();
+  while (p != e && *p == '0') ++p, ++n;  // leading zeros do not count towards overflow
+  std::size_t sig = 0;
+  if constexpr (std::endian::native == std::endian::little) {
+    for (std::uint64_t v; e - p >= 8 && sig + 8 <= 16; p += 8, sig += 8) {
+      std::memcpy(&v, p, 8);
+      if (!digits8(v)) break;
+      m = m * 100000000 + value8(v);
+    }
+  }
+  for (; p != e && *p >= '0' && *p <= '9'; ++p, ++sig) {
+    auto const d = static_cast<std::uint64_t>(*p - '0');
+    if (sig >= 19 && (m > (UINT64_MAX - d) / 10)) {
+      while (p != e && *p >= '0' && *p <= '9') ++p, ++sig;
+      n += sig;
+      return IS_OVERFLOW;
+    }
+    m = m * 10 + d;
+  }
+  n += sig;
+  return n ? IS_SUCCESS : IS_INCONVERTIBLE;
+}
+
+}  // namespace number
+
+// base 10 and all of s, no leading whitespace or '+' as with std::from_chars, floating point
+//  uses std::from_chars general format. Integers are parsed eight digits at a time.
+template <typename T>
+Parsed<T> parse(std::string_view s) {
+  static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "parse needs a number type");
+  Parsed<T> r;
+  if (s.empty()) return r;
+  if constexpr (std::is_floating_point_v<T>) {
+#if defined(__cpp_lib_to_chars)
+    auto const [p, ec] = std::from_chars(s.data(), s.data() + s.size(), r.value);
+    if (ec == std::errc::invalid_argument || p != s.data() + s.size()) return r;
+    auto const range = ec == std::errc::result_out_of_range;
+#else
+    std::string const c(s);
+    char* end = nullptr;
+    errno = 0;
+    if constexpr (std::is_same_v<T, float>)
+      r.value = std::strtof(c.c_str(), &end);
+    else if constexpr (std::is_same_v<T, double>)
+      r.value = std::strtod(c.c_str(), &end);
+    else
+      r.value = std::strtold(c.c_str(), &end);
+    if (end != c.c_str() + c.size() || std::isspace(static_cast<unsigned char>(c[0]))) return r;
+    auto const range = errno == ERANGE;
+#endif
+    if (range) {
+      auto const x = s.find_first_of("eE");
+      r.ret = x != std::string_view::npos && s.substr(x + 1).starts_with('-') ? IS_UNDERFLOW
+                                                                                : IS_OVERFLOW;
+    } else
+      r.ret = IS_SUCCESS;
+    return r;
+  } else {
+    bool const neg = s[0] == '-';
+    if (neg) s.remove_prefix(1);
+    std::uint64_t m = 0;
+    std::size_t n = 0;
+    auto const ret = number::magnitude(s, m, n);
+    if (ret == IS_INCONVERTIBLE || n != s.size()) return r;
+    auto const over = ret == IS_OVERFLOW;
+    if constexpr (std::is_unsigned_v<T>) {
+      if (neg && (over || m))
+        r.ret = IS_UNDERFLOW;
+      else if (over || m > (std::numeric_limits<T>::max)())
+        r.ret = IS_OVERFLOW;
+      else
+        r.ret = IS_SUCCESS, r.value = static_cast<T>(m);
+    } else {
+      using U = std::make_unsigned_t<T>;
+      auto const lim = static_cast<std::uint64_t>(static_cast<U>((std::numeric_limits<T>::max)()));
+      if (over || m > lim + neg)
+        r.ret = neg ? IS_UNDERFLOW : IS_OVERFLOW;
+      else
+        r.ret = IS_SUCCESS,
+        r.value = neg ? static_cast<T>(0 - static_cast<U>(m)) : static_cast<T>(m);
+    }
+    return r;
+  }
+}
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_STRING_NUM_HPP_ */
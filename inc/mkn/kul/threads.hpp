@@ -33,18 +33,43 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "mkn/kul/defs.hpp"
 #include "mkn/kul/map.hpp"
+#include "mkn/kul/queue.hpp"
 #include "mkn/kul/os/threads.hpp"
+#include "mkn/kul/threads/lock.hpp"
+#include "mkn/kul/threads/steal.hpp"
+#include "mkn/kul/threads/future.hpp"
+
+#include <optional>
 
 namespace mkn {
 namespace kul {
 
+// works with any of Mutex, PlainMutex, AdaptiveMutex, TicketLock or RWLock (exclusively)
+template <typename M = Mutex>
 class ScopeLock {
  private:
-  Mutex& m;
+  M& m;
 
  public:
-  ScopeLock(Mutex& _m) : m(_m) { this->m.lock(); }
+  ScopeLock(M& _m) : m(_m) { this->m.lock(); }
   ~ScopeLock() { this->m.unlock(); }
+
+  ScopeLock(ScopeLock const&) = delete;
+  ScopeLock& operator=(ScopeLock const&) = delete;
+};
+
+// read side of an RWLock
+template <typename M = RWLock>
+class SharedScopeLock {
+ private:
+  M& m;
+
+ public:
+  SharedScopeLock(M& _m) : m(_m) { this->m.lockShared(); }
+  ~SharedScopeLock() { this->m.unlockShared(); }
+
+  SharedScopeLock(SharedScopeLock const&) = delete;
+  SharedScopeLock& operator=(SharedScopeLock const&) = delete;
 };
 
 class ThreadQueue {
@@ -188,7 +213,7 @@ class ConcurrentThreadQueue {
       this_thread::nSleep(nWait);
       {
         mkn::kul::ScopeLock l(_qmutex);
-        if (_q.empty()) stop();
+        if (!queued()) stop();
       }
     }
     return *this;
@@ -212,15 +237,26 @@ class ConcurrentThreadQueue {
   bool async(std::function<F>&& function,
              std::function<void(E const&)>&& exception = std::function<void(E const&)>()) {
     if (_block) return false;
-    {
-      auto pair = std::unique_ptr<std::pair<std::function<F>, std::function<void(E const&)>>>(
-          new std::pair<std::function<F>, std::function<void(E const&)>>(function, exception));
+    // once jobs spill into _o the rest follow them there until it drains, so none overtake
+    if (_overflow || !_q.try_emplace(std::move(function), std::move(exception))) {
       mkn::kul::ScopeLock l(_qmutex);
-      _q.push(std::move(pair));
+      _o.emplace(std::move(function), std::move(exception));
+      _overflow = 1;
     }
     return true;
   }
 
+  // as async but the result, or any exception, is available from the returned Future
+  template <typename Fn>
+    requires(std::is_same_v<F, void()>)
+  auto submit(Fn&& fn, std::function<void(E const&)>&& exception = std::function<void(E const&)>()) {
+    auto [job, fut] = threading::package<E>(std::forward<Fn>(fn), std::move(exception));
+    if (!async(std::move(job)))
+      return threading::failed<typename decltype(fut)::value_type>(std::make_exception_ptr(
+          threading::Exception(__FILE__, __LINE__, "ConcurrentThreadQueue is blocked")));
+    return fut;
+  }
+
   std::exception_ptr const& exception() const { return _thread.exception(); }
 
   void rethrow() {
@@ -230,13 +266,34 @@ class ConcurrentThreadQueue {
  protected:
   size_t _cur = 0, _max = 1;
   uint64_t const m_nWait;
-  std::atomic<bool> _block, _detatched, _up;
-  std::queue<std::unique_ptr<std::pair<std::function<F>, std::function<void(E const&)>>>> _q;
+  using Job = std::pair<std::function<F>, std::function<void(E const&)>>;
+
+  std::atomic<bool> _block, _detatched, _up, _overflow{0};
+  mkn::kul::MPMCQueue<Job, MKN_KUL_THREAD_QUEUE_SIZE> _q;
+  std::queue<Job> _o;  // used from when _q is full until it is empty again, guarded by _qmutex
+  std::size_t _n = 0;
   mkn::kul::hash::map::S2T<std::shared_ptr<mkn::kul::Thread>> _k;
   mkn::kul::hash::map::S2T<std::function<void(E const&)>> _e;
 
   mkn::kul::Thread _thread;
-  mkn::kul::Mutex _mmutex, _qmutex;
+  mkn::kul::Mutex _mmutex;      // recursive, exception handlers may call back into the queue
+  mkn::kul::PlainMutex _qmutex;  // never held across user code
+
+  bool queued() const { return !_q.empty() || _overflow; }
+  // _qmutex must be held if locked, jobs in _q are older than any in _o
+  bool pop(Job& job, bool const locked = false) {
+    if (_q.try_pop(job)) return true;
+    if (!_overflow) return false;
+    if (!locked) {
+      mkn::kul::ScopeLock l(_qmutex);
+      return pop(job, true);
+    }
+    if (_o.empty()) return false;
+    job = std::move(_o.front());
+    _o.pop();
+    if (_o.empty()) _overflow = 0;
+    return true;
+  }
 
   void kthrow_(std::exception_ptr const& ep, std::function<void(E const&)> const& func) {
     try {
@@ -248,23 +305,15 @@ class ConcurrentThreadQueue {
   virtual void operator()() {
     while (_up) {
       this_thread::nSleep(m_nWait);
-      {
-        mkn::kul::ScopeLock l(_qmutex);
-        if (_q.empty()) continue;
-      }
+      if (!queued()) continue;
 
       for (; _cur < _max; _cur++) {
-        mkn::kul::ScopeLock l(_qmutex);
-        if (_q.empty()) break;
-        auto& f_ptr(_q.front());
-        auto& f(*f_ptr.get());
-        std::stringstream ss;
-        ss << &f;
-        auto k(ss.str());
+        Job f;
+        if (!pop(f)) break;
+        auto k(std::to_string(_n++));
         _k.insert(k, std::make_shared<mkn::kul::Thread>(f.first));
         _e.insert(k, f.second);
         _k[k]->run();
-        _q.pop();
       }
 
       mkn::kul::hash::set::String del;
@@ -383,7 +432,7 @@ class ConcurrentThreadPool : public ConcurrentThreadQueue<void()> {
       {
         mkn::kul::ScopeLock l1(_qmutex);
         mkn::kul::ScopeLock l2(_mmutex);
-        if (_q.empty()) {
+        if (!queued() && !_next) {
           size_t i;
           for (i = 0; i < _max; i++)
             if (!_p[std::to_string(i)]->ready()) break;
@@ -420,23 +469,24 @@ class ConcurrentThreadPool : public ConcurrentThreadQueue<void()> {
 
  protected:
   mkn::kul::hash::map::S2T<std::shared_ptr<PT>> _p;
+  std::optional<Job> _next;  // popped but no worker was ready for it yet
 
   virtual bool operate() {
-    bool qEmpty = 0;
-    {
-      mkn::kul::ScopeLock l(_qmutex);
-      qEmpty = _q.empty();
-    }
+    bool qEmpty = !_next && !queued();
     if (!qEmpty) {
-      mkn::kul::ScopeLock l(_qmutex);
+      mkn::kul::ScopeLock l(_qmutex);  // excludes finish() from seeing a job in flight here
       for (size_t i = 0; i < _max; i++) {
+        if (!_next) {
+          _next.emplace();
+          if (!pop(*_next, true)) {
+            _next.reset();
+            break;
+          }
+        }
         auto const n = std::to_string(i);
-        auto& f_ptr(_q.front());
-        auto& f(*f_ptr.get());
-        if (!_p[n]->if_ready_set(f.first)) continue;
-        _e[n] = f.second;
-        _q.pop();
-        if (_q.empty()) break;
+        if (!_p[n]->if_ready_set(_next->first)) continue;
+        _e[n] = _next->second;
+        _next.reset();
       }
     }
 
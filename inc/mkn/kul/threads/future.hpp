@@ -0,0 +1,284 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/threads.hpp"
+
+#ifndef MKN_KUL_THREADS_FUTURE_HPP_
+#define MKN_KUL_THREADS_FUTURE_HPP_
+
+#include "mkn/kul/os/any/threads/def.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+namespace mkn::kul {
+
+template <typename T>
+class Future;
+template <typename T>
+class Promise;
+
+namespace threading {
+
+template <typename T>
+class FutureState {
+  using value_type = std::conditional_t<std::is_void_v<T>, bool, T>;
+
+ public:
+  bool ready() const {
+    std::lock_guard<std::mutex> l(m);
+    return done;
+  }
+  void wait() const {
+    std::unique_lock<std::mutex> l(m);
+    cv.wait(l, [&]() { return done; });
+  }
+  template <typename Rep, typename Period>
+  bool wait_for(std::chrono::duration<Rep, Period> const& d) const {
+    std::unique_lock<std::mutex> l(m);
+    return cv.wait_for(l, d, [&]() { return done; });
+  }
+
+  template <typename... Args>
+  void value(Args&&... args) {
+    {
+      std::lock_guard<std::mutex> l(m);
+      if (done) KEXCEPT(Exception, "Future already satisfied");
+      v.emplace(std::forward<Args>(args)...);
+    }
+    complete();
+  }
+  void exception(std::exception_ptr const& _ep) {
+    {
+      std::lock_guard<std::mutex> l(m);
+      if (done) KEXCEPT(Exception, "Future already satisfied");
+      ep = _ep;
+    }
+    complete();
+  }
+
+  // runs f immediately if already satisfied, else on the thread which satisfies it
+  void on_ready(std::function<void()>&& f) {
+    {
+      std::lock_guard<std::mutex> l(m);
+      if (!done) {
+        cbs.emplace_back(std::move(f));
+        return;
+      }
+    }
+    f();
+  }
+
+  value_type& get() {
+    wait();
+    if (ep) std::rethrow_exception(ep);
+    return *v;
+  }
+  std::exception_ptr const& exception() const { return ep; }
+
+ private:
+  void complete() {
+    std::vector<std::function<void()>> fs;
+    {
+      std::lock_guard<std::mutex> l(m);
+      done = true;
+      fs.swap(cbs);
+    }
+    cv.notify_all();
+    for (auto& f : fs) f();
+  }
+
+  bool done = false;
+  std::optional<value_type> v;
+  std::exception_ptr ep;
+  std::vector<std::function<void()>> cbs;
+  mutable std::mutex m;
+  mutable std::condition_variable cv;
+};
+
+}  // namespace threading
+
+// Copyable handle to a result produced on another thread, akin to std::shared_future
+//  get() blocks and returns a reference into the shared state, or rethrows
+template <typename T>
+class Future {
+  friend class Promise<T>;
+
+ public:
+  using value_type = T;
+
+  Future() = default;
+
+  bool valid() const { return bool(_s); }
+  bool ready() const { return _s && _s->ready(); }
+  void wait() const { state().wait(); }
+  template <typename Rep, typename Period>
+  bool wait_for(std::chrono::duration<Rep, Period> const& d) const {
+    return state().wait_for(d);
+  }
+
+  decltype(auto) get() {
+    if constexpr (std::is_void_v<T>)
+      state().get();
+    else
+      return state().get();
+  }
+
+  std::exception_ptr exception() const {
+    wait();
+    return _s->exception();
+  }
+  void on_ready(std::function<void()>&& f) { state().on_ready(std::move(f)); }
+
+ private:
+  Future(std::shared_ptr<threading::FutureState<T>> const& s) : _s(s) {}
+
+  threading::FutureState<T>& state() const {
+    if (!_s) KEXCEPT(threading::Exception, "Future has no state");
+    return *_s;
+  }
+
+  std::shared_ptr<threading::FutureState<T>> _s;
+};
+
+template <typename T>
+class Promise {
+ public:
+  Promise() : _s(std::make_shared<threading::FutureState<T>>()) {}
+
+  Future<T> future() const { return Future<T>(_s); }
+
+  template <typename... Args>
+  void value(Args&&... args) const {
+    _s->value(std::forward<Args>(args)...);
+  }
+  void exception(std::exception_ptr const& ep) const { _s->exception(ep); }
+
+ private:
+  std::shared_ptr<threading::FutureState<T>> _s;
+};
+
+namespace threading {
+
+// wraps fn so its result or exception satisfies the returned Future,
+//  an exception of type E is first passed to the handler if one is given
+template <typename E, typename Fn, typename R = std::invoke_result_t<std::decay_t<Fn>&>>
+auto package(Fn&& fn, std::function<void(E const&)>&& handler) {
+  Promise<R> p;
+  auto fut = p.future();
+  std::function<void()> job = [p, fn = std::forward<Fn>(fn), h = std::move(handler)]() mutable {
+    try {
+      if constexpr (std::is_void_v<R>) {
+        fn();
+        p.value(true);
+      } else
+        p.value(fn());
+    } catch (E const& e) {
+      auto ep = std::current_exception();
+      try {
+        if (h) h(e);
+      } catch (...) {  // a throwing handler must not leave the Future unsatisfied
+      }
+      p.exception(ep);
+    } catch (...) {
+      p.exception(std::current_exception());
+    }
+  };
+  return std::make_pair(std::move(job), std::move(fut));
+}
+
+template <typename T>
+Future<T> failed(std::exception_ptr const& ep) {
+  Promise<T> p;
+  p.exception(ep);
+  return p.future();
+}
+
+}  // namespace threading
+
+// satisfied once every input is, holding copies of their values in order or the first exception
+template <typename T>
+auto when_all(std::vector<Future<T>> fs) {
+  using R = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+  Promise<R> p;
+  auto out = p.future();
+  if (fs.empty()) {
+    if constexpr (std::is_void_v<T>)
+      p.value(true);
+    else
+      p.value();
+    return out;
+  }
+  auto ins = std::make_shared<std::vector<Future<T>>>(std::move(fs));
+  auto left = std::make_shared<std::atomic<std::size_t>>(ins->size());
+  for (auto& f : *ins)
+    f.on_ready([p, ins, left]() {
+      if (left->fetch_sub(1) != 1) return;
+      for (auto& in : *ins)
+        if (auto ep = in.exception()) return p.exception(ep);
+      if constexpr (std::is_void_v<T>)
+        p.value(true);
+      else {
+        std::vector<T> vals;
+        vals.reserve(ins->size());
+        for (auto& in : *ins) vals.emplace_back(in.get());  // other copies may still read it
+        p.value(std::move(vals));
+      }
+    });
+  return out;
+}
+
+// satisfied with the index of the first input to be satisfied
+template <typename T>
+Future<std::size_t> when_any(std::vector<Future<T>> fs) {
+  if (fs.empty())
+    return threading::failed<std::size_t>(std::make_exception_ptr(
+        threading::Exception(__FILE__, __LINE__, "when_any requires at least one Future")));
+  Promise<std::size_t> p;
+  auto out = p.future();
+  auto hit = std::make_shared<std::atomic<bool>>(false);
+  for (std::size_t i = 0; i < fs.size(); ++i)
+    fs[i].on_ready([p, hit, i]() {
+      if (!hit->exchange(true)) p.value(i);
+    });
+  return out;
+}
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_THREADS_FUTURE_HPP_ */
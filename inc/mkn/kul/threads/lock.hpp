@@ -0,0 +1,130 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/threads.hpp"
+
+#ifndef MKN_KUL_THREADS_LOCK_HPP_
+#define MKN_KUL_THREADS_LOCK_HPP_
+
+#include "mkn/kul/defs.hpp"
+
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// spins before an AdaptiveMutex parks the thread or a TicketLock waiter yields
+#ifndef MKN_KUL_LOCK_SPIN
+#define MKN_KUL_LOCK_SPIN 128
+#endif
+
+namespace mkn::kul {
+namespace threading {
+
+// hint to the core that we are busy waiting
+inline void relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+}  // namespace threading
+
+// non-recursive, spins briefly then sleeps on the lock word (futex on linux) until woken
+//  for short critical sections where a syscall would cost more than the wait
+class AdaptiveMutex {
+ private:
+  // 0 unlocked, 1 locked, 2 locked with possible sleepers
+  std::atomic<std::uint32_t> s{0};
+
+ public:
+  AdaptiveMutex() {}
+  bool tryLock() {
+    std::uint32_t c = 0;
+    return s.compare_exchange_strong(c, 1, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+  void lock() {
+    for (std::size_t i = 0; i < MKN_KUL_LOCK_SPIN; ++i) {
+      if (s.load(std::memory_order_relaxed) == 0 && tryLock()) return;
+      threading::relax();
+    }
+    while (s.exchange(2, std::memory_order_acquire) != 0) s.wait(2, std::memory_order_relaxed);
+  }
+  void unlock() {
+    if (s.exchange(0, std::memory_order_release) == 2) s.notify_one();
+  }
+
+  AdaptiveMutex(AdaptiveMutex const&) = delete;
+  AdaptiveMutex& operator=(AdaptiveMutex const&) = delete;
+};
+
+// FIFO spinlock, threads acquire in arrival order so none starve under contention
+//  never sleeps, only for very short critical sections with fewer threads than cores
+//  waiters yield after MKN_KUL_LOCK_SPIN tries
+class TicketLock {
+ private:
+  alignas(MKN_KUL_CACHE_LINE_SIZE) std::atomic<std::uint32_t> next{0};
+  alignas(MKN_KUL_CACHE_LINE_SIZE) std::atomic<std::uint32_t> serving{0};
+
+ public:
+  TicketLock() {}
+  bool tryLock() {
+    auto t = serving.load(std::memory_order_relaxed);
+    return next.compare_exchange_strong(t, t + 1, std::memory_order_acquire,
+                                        std::memory_order_relaxed);
+  }
+  void lock() {
+    auto const t = next.fetch_add(1, std::memory_order_relaxed);
+    for (std::size_t i = 0; serving.load(std::memory_order_acquire) != t; ++i)
+      if (i < MKN_KUL_LOCK_SPIN)
+        threading::relax();
+      else
+        std::this_thread::yield();  // the holder may not be running
+  }
+  void unlock() {
+    serving.store(serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  TicketLock(TicketLock const&) = delete;
+  TicketLock& operator=(TicketLock const&) = delete;
+};
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_THREADS_LOCK_HPP_ */
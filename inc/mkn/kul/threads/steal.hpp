@@ -0,0 +1,425 @@
+/**
+Copyright (c) 2026, Philip Deegan.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the following disclaimer
+in the documentation and/or other materials provided with the
+distribution.
+    * Neither the name of Philip Deegan nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// IWYU pragma: private, include "mkn/kul/threads.hpp"
+
+#ifndef MKN_KUL_THREADS_STEAL_HPP_
+#define MKN_KUL_THREADS_STEAL_HPP_
+
+#include "mkn/kul/cpu.hpp"
+#include "mkn/kul/defs.hpp"
+#include "mkn/kul/except.hpp"
+#include "mkn/kul/queue.hpp"
+#include "mkn/kul/os/threads.hpp"
+#include "mkn/kul/threads/future.hpp"
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+namespace mkn::kul {
+namespace threading {
+
+// Chase-Lev deque: the owning thread pushes/pops at the bottom, any thread may steal from the top
+//  old rings are kept until destruction as a concurrent thief may still be reading from one
+template <typename T>
+class WorkStealingDeque {
+  struct Ring {
+    Ring(std::int64_t const c) : cap(c), mask(c - 1), buf(new std::atomic<T*>[c]) {}
+    T* get(std::int64_t const i) const { return buf[i & mask].load(std::memory_order_relaxed); }
+    void put(std::int64_t const i, T* t) { buf[i & mask].store(t, std::memory_order_relaxed); }
+    Ring* grow(std::int64_t const b, std::int64_t const t) const {
+      auto* r = new Ring(cap * 2);
+      for (auto i = t; i < b; ++i) r->put(i, get(i));
+      return r;
+    }
+
+    std::int64_t const cap, mask;
+    std::unique_ptr<std::atomic<T*>[]> buf;
+  };
+
+ public:
+  WorkStealingDeque(std::int64_t const cap = 256) : _ring(new Ring(cap)) {
+    if (cap < 2 || (cap & (cap - 1))) KEXCEPTION("WorkStealingDeque capacity must be a power of 2");
+    _rings.emplace_back(_ring.load(std::memory_order_relaxed));
+  }
+
+  void push(T* t) {  // owner only
+    auto const b = _bottom.load(std::memory_order_relaxed);
+    auto const f = _top.load(std::memory_order_acquire);
+    auto* r = _ring.load(std::memory_order_relaxed);
+    if (b - f > r->cap - 1) {
+      r = r->grow(b, f);
+      _rings.emplace_back(r);
+      _ring.store(r, std::memory_order_release);
+    }
+    r->put(b, t);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  T* pop() {  // owner only
+    auto const b = _bottom.load(std::memory_order_relaxed) - 1;
+    auto* r = _ring.load(std::memory_order_relaxed);
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto f = _top.load(std::memory_order_relaxed);
+    T* t = nullptr;
+    if (f <= b) {
+      t = r->get(b);
+      if (f == b) {  // last item, race any thieves for it
+        if (!_top.compare_exchange_strong(f, f + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+          t = nullptr;
+        _bottom.store(b + 1, std::memory_order_relaxed);
+      }
+    } else
+      _bottom.store(b + 1, std::memory_order_relaxed);
+    return t;
+  }
+
+  T* steal() {  // any thread, nullptr if empty or the race was lost
+    auto f = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto const b = _bottom.load(std::memory_order_acquire);
+    if (f >= b) return nullptr;
+    T* t = _ring.load(std::memory_order_acquire)->get(f);
+    if (!_top.compare_exchange_strong(f, f + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return nullptr;
+    return t;
+  }
+
+  std::int64_t size() const {
+    auto const b = _bottom.load(std::memory_order_relaxed);
+    auto const f = _top.load(std::memory_order_relaxed);
+    return b > f ? b - f : 0;
+  }
+  bool empty() const { return size() == 0; }
+
+ private:
+  alignas(MKN_KUL_CACHE_LINE_SIZE) std::atomic<std::int64_t> _top{0};
+  alignas(MKN_KUL_CACHE_LINE_SIZE) std::atomic<std::int64_t> _bottom{0};
+  alignas(MKN_KUL_CACHE_LINE_SIZE) std::atomic<Ring*> _ring;
+  std::vector<std::unique_ptr<Ring>> _rings;
+
+  WorkStealingDeque(WorkStealingDeque const&) = delete;
+  WorkStealingDeque(WorkStealingDeque&&) = delete;
+  WorkStealingDeque& operator=(WorkStealingDeque const&) = delete;
+  WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+};
+
+}  // namespace threading
+
+// Same async/block/finish/join surface as ConcurrentThreadPool<E>
+//  each worker owns a deque, idle workers steal from the others and then park on a condition
+//  variable rather than sleep polling. Jobs posted from a worker go to its own deque, all others
+//  go through a shared lock-free injection queue.
+//  nWait is kept for signature compatibility with ConcurrentThreadPool and is unused.
+template <class E = mkn::kul::Exception>
+class WorkStealingPool {
+  struct Task {
+    std::function<void()> f;
+    std::function<void(E const&)> e;
+  };
+  struct Worker {
+    threading::WorkStealingDeque<Task> q;
+    std::unique_ptr<mkn::kul::Thread> t;
+  };
+  struct Local {
+    WorkStealingPool const* pool = nullptr;
+    std::size_t idx = 0;
+  };
+
+ public:
+  WorkStealingPool(std::size_t const& max = 1, bool strt = 0,
+                   [[maybe_unused]] std::uint64_t const& nWait = 1000000)
+      : _max(max ? max : 1) {
+    for (std::size_t i = 0; i < _max; ++i) {
+      _w.emplace_back(std::make_unique<Worker>());
+      _w.back()->t = std::make_unique<mkn::kul::Thread>(std::function<void()>([this, i]() {
+        work(i);
+      }));
+    }
+    if (strt) start();
+  }
+  virtual ~WorkStealingPool() {
+    try {
+      stop();
+      join();
+    } catch (std::exception const& e) {
+      std::cerr << e.what() << std::endl;
+    } catch (...) {
+      std::cerr << "UNKNOWN EXCEPTION CAUGHT" << std::endl;
+    }
+    for (auto& w : _w)
+      while (auto* t = w->q.pop()) delete t;
+    Task* t = nullptr;
+    while (_inject.try_pop(t)) delete t;
+    for (auto* o : _overflow) delete o;
+  }
+
+  // pin worker i to the first hardware thread of the i'th physical core, wrapping around
+  //  when there are more workers than cores. Cores are taken node by node, so with one worker
+  //  per core, workers sharing a NUMA node are adjacent. Call before start()
+  WorkStealingPool& pin(cpu::Topology const& topo = cpu::topology()) {
+    if (_up) KEXCEPT(threading::Exception, "WorkStealingPool must be pinned before start");
+    auto const cores = topo.primaries();
+    for (std::size_t i = 0; i < _max && cores.size(); ++i)
+      _w[i]->t->affinity({cores[i % cores.size()]});
+    return *this;
+  }
+
+  // f(worker index) runs on each worker thread as it starts, before it takes any job,
+  //  memory allocated and first written there is placed on that worker's NUMA node
+  WorkStealingPool& onStart(std::function<void(std::size_t)>&& f) {
+    if (_up) KEXCEPT(threading::Exception, "WorkStealingPool has already started");
+    _starts.emplace_back(std::move(f));
+    return *this;
+  }
+
+  WorkStealingPool& start() {
+    if (!_up) {
+      _up = 1;
+      for (auto& w : _w) w->t->run();
+    }
+    return *this;
+  }
+  WorkStealingPool& stop() {
+    _up = 0;
+    {
+      std::lock_guard<std::mutex> l(_park_m);
+      _park_cv.notify_all();
+    }
+    std::lock_guard<std::mutex> l(_done_m);
+    _done_cv.notify_all();
+    return *this;
+  }
+  WorkStealingPool& block() {
+    _block = 1;
+    return *this;
+  }
+  WorkStealingPool& unblock() {
+    _block = 0;
+    return *this;
+  }
+  WorkStealingPool& join() {
+    for (auto& w : _w)
+      if (w->t->started()) w->t->join();
+    return *this;
+  }
+  // starts the workers if none are running, waits for every posted job to complete or for an
+  //  unhandled exception, stops, then rethrows that exception
+  WorkStealingPool& finish([[maybe_unused]] std::uint64_t const& nWait = 1000000)
+      KTHROW(mkn::kul::Exception) {
+    if (std::none_of(_w.begin(), _w.end(), [](auto const& w) { return w->t->started(); }))
+      start();
+    {
+      std::unique_lock<std::mutex> l(_done_m);
+      _done_cv.wait(l, [&]() { return !_up || _ep || _pending.load() == 0; });
+    }
+    stop();
+    rethrow();
+    return *this;
+  }
+
+  bool async(std::function<void()>&& function,
+             std::function<void(E const&)>&& exception = std::function<void(E const&)>()) {
+    if (_block) return false;
+    auto* task = new Task{std::move(function), std::move(exception)};
+    _pending.fetch_add(1);
+    _queued.fetch_add(1);  // before the task is visible, so a thief can never take it below zero
+    auto const& l = local();
+    if (l.pool == this)
+      _w[l.idx]->q.push(task);
+    else if (!_inject.try_push(task)) {
+      std::lock_guard<std::mutex> lock(_overflow_m);
+      _overflow.push_back(task);
+      _overflowed = 1;
+    }
+    if (_sleepers.load()) {
+      std::lock_guard<std::mutex> lock(_park_m);
+      _park_cv.notify_one();
+    }
+    return true;
+  }
+
+  // as async but the result, or any exception, is available from the returned Future
+  template <typename Fn>
+  auto submit(Fn&& fn, std::function<void(E const&)>&& exception = std::function<void(E const&)>()) {
+    auto [job, fut] = threading::package<E>(std::forward<Fn>(fn), std::move(exception));
+    if (!async(std::move(job)))
+      return threading::failed<typename decltype(fut)::value_type>(std::make_exception_ptr(
+          threading::Exception(__FILE__, __LINE__, "WorkStealingPool is blocked")));
+    return fut;
+  }
+
+  // run one queued job on the calling thread if there is one, for callers waiting on the pool
+  bool help() {
+    auto const& l = local();
+    auto* t = l.pool == this ? next(l.idx) : next(0, false);
+    if (t) run(t);
+    return t;
+  }
+
+  std::size_t size() const { return _max; }
+  // index of the calling worker, size() if the caller is not one of this pool's workers
+  std::size_t worker() const {
+    auto const& l = local();
+    return l.pool == this ? l.idx : _max;
+  }
+  std::exception_ptr const& exception() const { return _ep; }
+  void rethrow() {
+    if (_ep) std::rethrow_exception(_ep);
+  }
+
+ protected:
+  std::size_t const _max = 1;
+  std::atomic<bool> _block{0}, _up{0}, _overflowed{0};
+  std::atomic<std::size_t> _pending{0}, _queued{0}, _sleepers{0};
+  std::vector<std::unique_ptr<Worker>> _w;
+  mkn::kul::MPMCQueue<Task*, MKN_KUL_THREAD_QUEUE_SIZE> _inject;
+  std::deque<Task*> _overflow;  // only used once _inject is full
+  std::exception_ptr _ep;
+  std::mutex _overflow_m, _park_m, _done_m;
+  std::condition_variable _park_cv, _done_cv;
+  std::vector<std::function<void(std::size_t)>> _starts;
+
+  static Local& local() {
+    static thread_local Local l;
+    return l;
+  }
+
+  Task* next(std::size_t const i, bool const own = true) {
+    Task* t = own ? _w[i]->q.pop() : nullptr;
+    if (!t && !_inject.try_pop(t) && _overflowed) {
+      std::lock_guard<std::mutex> l(_overflow_m);
+      if (!_overflow.empty()) {
+        t = _overflow.front();
+        _overflow.pop_front();
+      }
+      _overflowed = !_overflow.empty();
+    }
+    for (std::size_t v = own; !t && v < _max; ++v) t = _w[(i + v) % _max]->q.steal();
+    if (t) _queued.fetch_sub(1);
+    return t;
+  }
+
+  void park() {
+    std::unique_lock<std::mutex> l(_park_m);
+    _sleepers.fetch_add(1);
+    _park_cv.wait(l, [&]() { return !_up || _queued.load() > 0; });
+    _sleepers.fetch_sub(1);
+  }
+
+  void run(Task* t) {
+    std::unique_ptr<Task> task(t);
+    try {
+      try {
+        task->f();
+      } catch (E const& e) {
+        if (!task->e) throw;
+        task->e(e);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> l(_done_m);
+      if (!_ep) _ep = std::current_exception();
+      _done_cv.notify_all();
+    }
+    if (_pending.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> l(_done_m);
+      _done_cv.notify_all();
+    }
+  }
+
+  void work(std::size_t const i) {
+    local() = Local{this, i};
+    try {
+      for (auto const& f : _starts) f(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> l(_done_m);
+      if (!_ep) _ep = std::current_exception();
+      _done_cv.notify_all();
+    }
+    while (_up) {
+      if (auto* t = next(i))
+        run(t);
+      else
+        park();
+    }
+    local() = Local{};
+  }
+
+  WorkStealingPool(WorkStealingPool const&) = delete;
+  WorkStealingPool(WorkStealingPool&&) = delete;
+  WorkStealingPool& operator=(WorkStealingPool const&) = delete;
+  WorkStealingPool& operator=(WorkStealingPool&&) = delete;
+};
+
+// one T per worker of a pool, each constructed on its own worker thread as the pool starts
+//  so pinned workers get node local memory by first touch. Must be created before the pool
+//  is started and outlive it
+template <typename T>
+class WorkerLocal {
+ public:
+  template <typename E, typename... Args>
+  WorkerLocal(WorkStealingPool<E>& pool, Args... args) : _ts(pool.size()) {
+    pool.onStart([this, args...](std::size_t const i) { _ts[i] = std::make_unique<T>(args...); });
+    _worker = [&pool]() { return pool.worker(); };
+  }
+
+  // the calling worker's T
+  T& local() {
+    auto const i = _worker();
+    if (i >= _ts.size() || !_ts[i]) KEXCEPT(threading::Exception, "Not a started pool worker");
+    return *_ts[i];
+  }
+  T& operator[](std::size_t const i) { return *_ts[i]; }
+  std::size_t size() const { return _ts.size(); }
+
+ private:
+  std::vector<std::unique_ptr<T>> _ts;
+  std::function<std::size_t()> _worker;
+
+  WorkerLocal(WorkerLocal const&) = delete;
+  WorkerLocal(WorkerLocal&&) = delete;
+  WorkerLocal& operator=(WorkerLocal const&) = delete;
+  WorkerLocal& operator=(WorkerLocal&&) = delete;
+};
+
+}  // namespace mkn::kul
+
+#endif /* MKN_KUL_THREADS_STEAL_HPP_ */
@@ -30,7 +30,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "mkn/kul/cli.hpp"
+#include "mkn/kul/io.hpp"
 #include "mkn/kul/log.hpp"
+#include "mkn/kul/log/defer.hpp"
 #include "mkn/kul/os.hpp"
 #include "mkn/kul/threads.hpp"
 
@@ -81,6 +83,72 @@ void splitStringByEscapedChar(benchmark::State& state) {
 }
 BENCHMARK(splitStringByEscapedChar)->Unit(benchmark::kMicrosecond);
 
+void splitViewByChar(benchmark::State& state) {
+  std::vector<std::string_view> v;
+  while (state.KeepRunning()) {
+    v.clear();
+    benchmark::DoNotOptimize(mkn::kul::split_view("split - by - char - dash", '-').into(v));
+  }
+}
+BENCHMARK(splitViewByChar)->Unit(benchmark::kMicrosecond);
+
+void replaceAllLong(benchmark::State& state) {
+  std::string const in = [] {
+    std::string s;
+    for (std::size_t i = 0; i < 10000; ++i) s += "-I/some/include/path ";
+    return s;
+  }();
+  while (state.KeepRunning()) {
+    auto s = in;
+    mkn::kul::String::REPLACE_ALL(s, " ", "\\ ");
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(replaceAllLong)->Unit(benchmark::kMicrosecond);
+
+std::vector<std::string> const numbers = [] {
+  std::vector<std::string> v;
+  for (std::uint64_t i = 0, n = 1; i < 1000; ++i, n = n * 6364136223846793005u + 1)
+    v.emplace_back(std::to_string(n >> (i % 40)));
+  return v;
+}();
+void parseUint64Throwing(benchmark::State& state) {
+  while (state.KeepRunning())
+    for (auto const& n : numbers) benchmark::DoNotOptimize(mkn::kul::String::UINT64(n));
+}
+BENCHMARK(parseUint64Throwing)->Unit(benchmark::kMicrosecond);
+void parseUint64(benchmark::State& state) {
+  while (state.KeepRunning())
+    for (auto const& n : numbers) benchmark::DoNotOptimize(mkn::kul::parse<std::uint64_t>(n));
+}
+BENCHMARK(parseUint64)->Unit(benchmark::kMicrosecond);
+
+void noCaseCompare(benchmark::State& state) {
+  std::string const a(200, 'x'), b(200, 'X');
+  while (state.KeepRunning()) benchmark::DoNotOptimize(mkn::kul::String::NO_CASE_CMP(a, b));
+}
+BENCHMARK(noCaseCompare)->Unit(benchmark::kMicrosecond);
+
+void stringStreamFormat(benchmark::State& state) {
+  std::string const h(40, 'h');
+  while (state.KeepRunning()) {
+    std::ostringstream ss;
+    ss << "request " << 123456 << " took " << 0.25 << "ms from " << h;
+    benchmark::DoNotOptimize(ss.str());
+  }
+}
+BENCHMARK(stringStreamFormat)->Unit(benchmark::kNanosecond);
+
+void stringBuilderFormat(benchmark::State& state) {
+  std::string const h(40, 'h');
+  while (state.KeepRunning()) {
+    mkn::kul::StringBuilder<> sb;
+    sb << "request " << 123456 << " took " << 0.25 << "ms from " << h;
+    benchmark::DoNotOptimize(sb.view());
+  }
+}
+BENCHMARK(stringBuilderFormat)->Unit(benchmark::kNanosecond);
+
 auto lambda = [](uint a, uint b) {
   auto c = (a + b);
   (void)c;
@@ -104,7 +172,92 @@ void chroncurrentThreadPool(benchmark::State& state) {
 }
 BENCHMARK(chroncurrentThreadPool)->Unit(benchmark::kMicrosecond);
 
+void workStealingPool(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    mkn::kul::WorkStealingPool<> wsp(3, 1);
+    for (size_t i = 0; i < 10000; i++) wsp.async(std::bind(lambda, 2, 4));
+    wsp.block().finish().join();
+  }
+}
+BENCHMARK(workStealingPool)->Unit(benchmark::kMicrosecond);
+
+void streamLogging(benchmark::State& state) {
+  auto& man = mkn::kul::LogMan::INSTANCE();
+  man.setMode(mkn::kul::log::mode::INF);
+  man.setOut([](std::string const&) {});
+  std::string const s = "string";
+  while (state.KeepRunning()) KLOG(INF) << "value " << 42 << " and " << s;
+  man.setOut(nullptr);
+}
+BENCHMARK(streamLogging)->Unit(benchmark::kNanosecond);
+
+void kvLogging(benchmark::State& state) {
+  auto& man = mkn::kul::LogMan::INSTANCE();
+  man.setMode(mkn::kul::log::mode::INF);
+  man.setOut([](std::string const&) {});
+  std::string const s = "string";
+  while (state.KeepRunning()) KLOG_KV(INF, "value", 42, "and", s);
+  man.setOut(nullptr);
+}
+BENCHMARK(kvLogging)->Unit(benchmark::kNanosecond);
+
+void deferredLogging(benchmark::State& state) {
+  auto& man = mkn::kul::LogMan::INSTANCE();
+  man.setMode(mkn::kul::log::mode::INF);
+  auto& logger = mkn::kul::log::DeferredLogger::INSTANCE();
+  std::FILE* null = std::fopen("/dev/null", "w");
+  if (null) logger.fd(fileno(null));
+  std::string const s = "string";
+  while (state.KeepRunning()) KDEFER(INF, "value {} and {}", 42, s);
+  logger.flush();
+  logger.fd(1);
+  if (null) std::fclose(null);
+}
+BENCHMARK(deferredLogging)->Unit(benchmark::kNanosecond);
+
+// ~8MB of lines between 20 and 139 characters, written once
+char const* linesFile() {
+  static char const* const path = []() {
+    char const* p = "mkn.kul.bench.lines";
+    mkn::kul::io::Writer w(p);
+    for (std::size_t i = 0; i < 100000; ++i) w << std::string(20 + i % 120, 'x') << "\n";
+    return p;
+  }();
+  return path;
+}
+
+void readerLines(benchmark::State& state) {
+  for (auto _ : state) {
+    mkn::kul::io::Reader r(linesFile());
+    std::size_t n = 0;
+    while (r.readLine()) ++n;
+    benchmark::DoNotOptimize(n);
+  }
+}
+BENCHMARK(readerLines)->Unit(benchmark::kMillisecond);
+
+void lineReaderLines(benchmark::State& state) {
+  for (auto _ : state) {
+    mkn::kul::io::LineReader r(linesFile());
+    std::size_t n = 0;
+    while (r.readLine()) ++n;
+    benchmark::DoNotOptimize(n);
+  }
+}
+BENCHMARK(lineReaderLines)->Unit(benchmark::kMillisecond);
+
+void mappedLines(benchmark::State& state) {
+  for (auto _ : state) {
+    mkn::kul::io::MappedReader r(linesFile());
+    std::size_t n = 0;
+    for (auto const line : r.lines()) n += !line.empty();
+    benchmark::DoNotOptimize(n);
+  }
+}
+BENCHMARK(mappedLines)->Unit(benchmark::kMillisecond);
+
 int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
   ::benchmark::RunSpecifiedBenchmarks();
+  std::remove("mkn.kul.bench.lines");
 }
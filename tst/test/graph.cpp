@@ -0,0 +1,58 @@
+#include "test_common.hpp"
+
+#include "mkn/kul/graph.hpp"
+
+#include <atomic>
+#include <vector>
+
+TEST(TaskGraph, runsInDependencyOrder) {
+  mkn::kul::WorkStealingPool<> pool(3, 1);
+  std::atomic<std::size_t> tick{0};
+  std::vector<std::size_t> at(5, 0);
+  mkn::kul::TaskGraph g;
+  auto a = g.add("a", [&]() { at[0] = ++tick; });
+  auto c = g.add("c", [&]() { at[1] = ++tick; });
+  auto b = g.add("b", [&]() { at[2] = ++tick; }, {a, c});
+  auto d = g.add("d", [&]() { at[3] = ++tick; }, {a});
+  g.add("link", [&]() { at[4] = ++tick; }, {b, d}, 3);
+  g.run(pool);
+  EXPECT_LT(at[0], at[2]);
+  EXPECT_LT(at[1], at[2]);
+  EXPECT_LT(at[0], at[3]);
+  EXPECT_LT(at[2], at[4]);
+  EXPECT_LT(at[3], at[4]);
+  pool.finish().join();
+
+  auto const r = g.plan();
+  EXPECT_EQ(r.order.size(), 5u);
+  EXPECT_EQ(r.level[4], 2u);
+  EXPECT_EQ(r.width, 2u);
+  EXPECT_EQ(r.critical_cost, 5);
+  EXPECT_EQ(r.total_cost, 7);
+  EXPECT_EQ(r.critical.back(), 4u);
+}
+
+TEST(TaskGraph, propagatesExceptions) {
+  std::atomic<bool> ran{0};
+  mkn::kul::TaskGraph g;
+  auto a = g.add("compile", []() { KEXCEPTION("compile failed"); });
+  g.add("link", [&]() { ran = 1; }, {a});
+  try {
+    g.run(2);
+    FAIL();
+  } catch (mkn::kul::graph::Exception const& e) {
+    EXPECT_NE(e.str().find("compile"), std::string::npos);
+    EXPECT_THROW(std::rethrow_exception(e.cause()), mkn::kul::Exception);
+  }
+  EXPECT_FALSE(ran);
+}
+
+TEST(TaskGraph, rejectsCycles) {
+  mkn::kul::TaskGraph g;
+  auto a = g.add("a", []() {});
+  auto b = g.add("b", []() {}, {a});
+  g.after(a, b);
+  EXPECT_THROW(g.plan(), mkn::kul::graph::Exception);
+  EXPECT_THROW(g.run(1), mkn::kul::graph::Exception);
+  EXPECT_THROW(g.after(a, 5), mkn::kul::graph::Exception);
+}
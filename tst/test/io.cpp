@@ -3,6 +3,16 @@
 #include "test_common.hpp"
 
 #include "mkn/kul/io.hpp"
+#include "mkn/kul/io/async.hpp"
+#include "mkn/kul/io/atomic.hpp"
+#include "mkn/kul/io/direct.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string_view>
 
 TEST(IO_Test, ReadFileLine) {
   mkn::kul::io::Reader r("LICENSE.md");
@@ -56,3 +66,264 @@ TEST(IO_Test, ReadBinaryFile) {
   EXPECT_EQ("Philip Deegan.\nAll r", ss.str());
 }
 #endif
+
+TEST(IO_Test, MappedReaderLinesAndChunks) {
+  mkn::kul::io::MappedReader r("LICENSE.md");
+  mkn::kul::io::Reader ref("LICENSE.md");
+  std::size_t n = 0;
+  for (auto const line : r.lines()) {
+    char const* c = ref.readLine();
+    ASSERT_TRUE(c);
+    EXPECT_EQ(line, c);
+    ++n;
+  }
+  EXPECT_FALSE(ref.readLine());
+  EXPECT_GT(n, 1u);
+
+  auto const first = r.readLine();
+  ASSERT_TRUE(first);
+  EXPECT_EQ(*first, "Copyright (c) 2026, Philip Deegan.");
+  EXPECT_EQ(r.read(4), "All ");
+
+  std::string all;
+  std::size_t chunks = 0;
+  for (auto const c : r.chunks(100)) {
+    EXPECT_LE(c.size(), 100u);
+    all += c;
+    ++chunks;
+  }
+  EXPECT_EQ(all, r.view());
+  EXPECT_EQ(chunks, (r.size() + 99) / 100);
+
+  EXPECT_THROW(mkn::kul::io::MappedReader("does/not/exist"), mkn::kul::io::Exception);
+}
+
+TEST(IO_Test, LinesKeepsEmptyAndStripsCR) {
+  std::vector<std::string_view> v;
+  for (auto const l : mkn::kul::io::Lines("a\r\n\nb")) v.emplace_back(l);
+  EXPECT_EQ(v, (std::vector<std::string_view>{"a", "", "b"}));
+  EXPECT_EQ(mkn::kul::io::Lines("").begin(), mkn::kul::io::Lines("").end());
+}
+
+TEST(IO_Test, LineReaderStraddlesRefills) {
+  for (std::size_t const buffer : {std::size_t{1}, std::size_t{7}, std::size_t{1} << 16}) {
+    mkn::kul::io::LineReader r("LICENSE.md", buffer);
+    mkn::kul::io::Reader ref("LICENSE.md");
+    std::size_t n = 0;
+    while (auto const line = r.readLine()) {
+      char const* c = ref.readLine();
+      ASSERT_TRUE(c);
+      EXPECT_EQ(*line, c);
+      ++n;
+    }
+    EXPECT_FALSE(ref.readLine());
+    EXPECT_GT(n, 1u);
+  }
+}
+
+#if !defined(_WIN32)
+TEST(IO_Test, LineReaderFromPipe) {
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  std::thread w([&]() {
+    for (std::string_view const s : {"ab\r", "\ncd\n", "\n", "tail without newline"})
+      if (::write(fds[1], s.data(), s.size()) < 0) break;
+    ::close(fds[1]);
+  });
+  std::vector<std::string> lines;
+  {
+    mkn::kul::io::LineReader r(fds[0], 4);
+    while (auto const line = r.readLine()) lines.emplace_back(*line);
+  }
+  w.join();
+  ::close(fds[0]);
+  EXPECT_EQ(lines, (std::vector<std::string>{"ab", "cd", "", "tail without newline"}));
+}
+#endif
+
+TEST(IO_Test, AsyncFileRoundTrip) {
+  using namespace mkn::kul::io;
+  constexpr std::size_t BLOCK = 4096, BLOCKS = 64;
+  std::string const path = "mkn.kul.async.bin";
+  for (auto const backend : {async::Backend::AUTO, async::Backend::THREADS}) {
+    std::vector<char> out(BLOCK * BLOCKS), in(BLOCK * BLOCKS, 0);
+    for (std::size_t i = 0; i < out.size(); ++i) out[i] = static_cast<char>(i * 31 + i / BLOCK);
+    std::size_t written = 0, red = 0;
+    {
+      AsyncFile f(path.c_str(), async::Access::WRITE, 8, backend);
+      EXPECT_EQ(f.uring(), backend == async::Backend::AUTO && f.uring());
+      for (std::size_t b = BLOCKS; b-- > 0;)  // out of order, more than depth in flight
+        f.write(&out[b * BLOCK], BLOCK, b * BLOCK, [&](std::int64_t const r) { written += r; });
+      f.drain();
+      EXPECT_EQ(f.inflight(), 0u);
+    }
+    EXPECT_EQ(written, out.size());
+    {
+      AsyncFile f(path.c_str(), async::Access::READ, 8, backend);
+      f.buffers({{in.data(), in.size()}});
+      for (std::size_t b = 0; b < BLOCKS; ++b)
+        f.read(&in[b * BLOCK], BLOCK, b * BLOCK, [&](std::int64_t const r) { red += r; });
+      f.submit();
+      while (f.inflight()) f.wait();
+      std::int64_t past = 1;
+      f.read(in.data(), BLOCK, out.size(), [&](std::int64_t const r) { past = r; });
+      f.drain();
+      EXPECT_EQ(past, 0);
+    }
+    EXPECT_EQ(red, out.size());
+    EXPECT_EQ(in, out);
+  }
+  std::remove(path.c_str());
+  EXPECT_THROW(AsyncFile("does/not/exist"), Exception);
+}
+
+TEST(IO_Test, BinaryWriterGathersAndPositions) {
+  using mkn::kul::Span;
+  using Bytes = Span<std::uint8_t const>;
+  std::string const path = "mkn.kul.writer.bin";
+  std::vector<std::uint8_t> const a{1, 2, 3}, b(100, 4), c{5};
+  {
+    mkn::kul::io::BinaryWriter w(path.c_str(), 16);
+    w << "ab";
+    w.write({Bytes(a), Bytes(b), Bytes(c)});
+    w.write(reinterpret_cast<char const*>(b.data()), std::size_t{20});  // larger than the buffer
+    w << 'z';
+  }
+  mkn::kul::io::MappedReader r(path.c_str());
+  ASSERT_EQ(r.size(), 2u + 3 + 100 + 1 + 20 + 1);
+  EXPECT_EQ(r.view().substr(0, 5), std::string_view("ab\1\2\3"));
+  EXPECT_EQ(r.view()[105], '\5');
+  EXPECT_EQ(r.view().back(), 'z');
+
+  constexpr std::size_t BLOCK = 1000, BLOCKS = 8;
+  {
+    mkn::kul::io::BinaryWriter w(path.c_str());
+    w.allocate(BLOCK * BLOCKS);
+    std::vector<std::thread> ts;
+    for (std::size_t t = 0; t < BLOCKS; ++t)
+      ts.emplace_back([&, t]() {
+        std::vector<std::uint8_t> const v(BLOCK, static_cast<std::uint8_t>(t));
+        w.pwrite(v, t * BLOCK);
+      });
+    for (auto& t : ts) t.join();
+  }
+  mkn::kul::io::MappedReader p(path.c_str());
+  ASSERT_EQ(p.size(), BLOCK * BLOCKS);
+  for (std::size_t i = 0; i < p.size(); ++i) ASSERT_EQ(p.data()[i], static_cast<char>(i / BLOCK));
+
+  std::string const next = path + ".next";
+  {  // nothing reaches whatever file reuses the fd number after close
+    mkn::kul::io::BinaryWriter w(path.c_str(), 16);
+    w << "ab";
+    w.close();
+    EXPECT_EQ(w.fd(), -1);
+    mkn::kul::io::BinaryWriter o(next.c_str());
+    o << "cd";
+    EXPECT_THROW(w.write({Bytes(a)}), mkn::kul::Exception);
+    EXPECT_THROW(w.pwrite(Bytes(a), 0), mkn::kul::Exception);
+    EXPECT_THROW(w.allocate(BLOCK), mkn::kul::Exception);
+    w << "ef";
+    w.write(reinterpret_cast<char const*>(b.data()), std::size_t{20});
+  }
+  EXPECT_EQ(mkn::kul::io::MappedReader(path.c_str()).view(), std::string_view("ab"));
+  EXPECT_EQ(mkn::kul::io::MappedReader(next.c_str()).view(), std::string_view("cd"));
+  std::remove(path.c_str());
+  std::remove(next.c_str());
+}
+
+TEST(IO_Test, DirectWriterReaderRoundTrip) {
+  std::string const path = "mkn.kul.direct.bin";
+  std::vector<std::uint8_t> data(3 * 8192 + 1234);  // ends in an unaligned tail
+  for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<std::uint8_t>(i * 7 + i / 251);
+  {
+    mkn::kul::io::DirectWriter w(path.c_str(), 8192);
+    w.write(data.data(), 100);
+    w.write(mkn::kul::Span<std::uint8_t const>(data.data() + 100, data.size() - 100));
+    w.close();
+    EXPECT_EQ(w.size(), data.size());
+  }
+  EXPECT_EQ(mkn::kul::File(path).size(), data.size());
+
+  std::vector<std::uint8_t> in;
+  {
+    mkn::kul::io::DirectReader r(path.c_str(), 8192);
+    for (auto s = r.next(); s.size(); s = r.next()) {
+      EXPECT_EQ(reinterpret_cast<std::uintptr_t>(s.data()) % mkn::kul::io::direct::ALIGN, 0u);
+      in.insert(in.end(), s.begin(), s.end());
+    }
+    EXPECT_EQ(r.next().size(), 0u);
+  }
+  EXPECT_EQ(in, data);
+  std::remove(path.c_str());
+}
+
+#if !MKN_KUL_IS_WIN
+TEST(IO_Test, DirectWriterFailureStillCloses) {
+  if (::access("/dev/full", W_OK) != 0) GTEST_SKIP();
+  std::vector<std::uint8_t> const data(10000, 1);
+  {
+    mkn::kul::io::DirectWriter w("/dev/full", 4096);
+    EXPECT_THROW(w.write(data.data(), data.size()), mkn::kul::Exception);
+  }  // must not terminate with the writer thread still joinable
+  mkn::kul::io::DirectWriter w("/dev/full", 4096);
+  w.write(data.data(), 100);
+  EXPECT_THROW(w.close(), mkn::kul::Exception);
+  EXPECT_THROW(w.write(data.data(), 1), mkn::kul::Exception);
+}
+#endif
+
+TEST(IO_Test, AtomicWriterReplacesOnCommit) {
+  std::string const path = "mkn.kul.atomic.txt";
+  auto const read = [](std::string const& p) {
+    std::string s;
+    for (mkn::kul::io::Reader r(p.c_str()); auto const* c = r.readLine();) s += c;
+    return s;
+  };
+  mkn::kul::io::Writer(path.c_str()) << "old";
+  {
+    mkn::kul::io::AtomicWriter w(path.c_str());
+    w << "new";
+    w.flush();
+    EXPECT_TRUE(mkn::kul::File(w.temp()).is());
+    EXPECT_EQ(read(path), "old");
+    w.commit();
+    EXPECT_FALSE(mkn::kul::File(w.temp()).is());
+  }
+  EXPECT_EQ(read(path), "new");
+  std::string temp;
+  {
+    mkn::kul::io::AtomicWriter w(path.c_str(), false);
+    w << "lost";
+    temp = w.temp();
+  }
+  EXPECT_FALSE(mkn::kul::File(temp).is());
+  EXPECT_EQ(read(path), "new");
+
+  mkn::kul::io::AtomicBatch batch;
+  for (std::size_t i = 0; i < 8; ++i) batch.add((path + std::to_string(i)).c_str()) << i;
+  EXPECT_EQ(batch.size(), 8u);
+  batch.commit();
+  EXPECT_EQ(batch.size(), 0u);
+  for (std::size_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(read(path + std::to_string(i)), std::to_string(i));
+    std::remove((path + std::to_string(i)).c_str());
+  }
+  std::remove(path.c_str());
+}
+
+#if !MKN_KUL_IS_WIN
+TEST(IO_Test, AtomicWriterKeepsTargetMode) {
+  std::string const path = "mkn.kul.atomic.sh";
+  mkn::kul::io::Writer(path.c_str()) << "#!/bin/sh";
+  ASSERT_EQ(::chmod(path.c_str(), 0750), 0);
+  {
+    mkn::kul::io::AtomicWriter w(path.c_str());
+    w << "#!/bin/sh\ntrue";
+    w.commit();
+  }
+  struct stat st;
+  ASSERT_EQ(::stat(path.c_str(), &st), 0);
+  EXPECT_EQ(st.st_mode & 07777, 0750u);
+  std::remove(path.c_str());
+}
+#endif
@@ -0,0 +1,272 @@
+#include "test_common.hpp"
+
+#include "mkn/kul/os.hpp"
+#include "mkn/kul/log/file.hpp"
+#include "mkn/kul/log/defer.hpp"
+
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <complex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+
+TEST(DeferredLogger, formatsOnConsumer) {
+  auto& man = mkn::kul::LogMan::INSTANCE();
+  auto const mode = man.mode();
+  man.setMode(mkn::kul::log::mode::INF);
+
+  auto* f = std::tmpfile();
+  ASSERT_TRUE(f);
+  auto& logger = mkn::kul::log::DeferredLogger::INSTANCE();
+  logger.fd(fileno(f));
+  std::string const s = "str";
+  KDEFER(INF, "int {} double {} string {} literal {}", 42, 2.5, s, "lit");
+  KDEFER(DBG, "filtered {}", 1);
+  std::thread t([]() { KDEFER(INF, "from {}", "thread"); });
+  t.join();
+  std::string const big(MKN_KUL_LOG_DEFER_RING * 2, 'b');
+  KDEFER(INF, "big {} {} end", big, big);  // cut to fit the ring rather than dropped
+  logger.flush();
+  logger.fd(1);
+  man.setMode(mode);
+
+  std::string out(MKN_KUL_LOG_DEFER_RING * 2, '\0');
+  std::rewind(f);
+  out.resize(std::fread(out.data(), 1, out.size(), f));
+  std::fclose(f);
+  EXPECT_NE(out.find("[INF]"), std::string::npos);
+  EXPECT_NE(out.find("int 42 double 2.5 string str literal lit"), std::string::npos);
+  EXPECT_NE(out.find("from thread"), std::string::npos);
+  EXPECT_EQ(out.find("filtered"), std::string::npos);
+  auto const b = out.find("big bbb");
+  ASSERT_NE(b, std::string::npos);
+  auto const e = out.find(" end", b);
+  ASSERT_NE(e, std::string::npos);
+  EXPECT_GT(e - b, std::size_t{MKN_KUL_LOG_DEFER_RING / 4});
+  EXPECT_LT(e - b, std::size_t{MKN_KUL_LOG_DEFER_RING / 2});
+}
+
+TEST(LogFormat, compilesSegments) {
+  mkn::kul::log::Format const fmt("<%M|%T|%F:%N#%L|%S|%X|%S>");
+  std::string out;
+  fmt.emit(out, mkn::kul::log::Line{mkn::kul::log::mode::DBG, "tid", 0, "file", "fn", 1234, "msg"});
+  EXPECT_EQ(out, "<DBG|tid|file:fn#1234|msg|%X|msg>");
+
+  mkn::kul::log::DateFormat const date("%i.%i");
+  out.clear();
+  date.emit(out, 1234567891ll * 1000000);
+  EXPECT_EQ(out, "891.891");
+}
+
+TEST(LogLevels, skipDisabledArguments) {
+  auto& man = mkn::kul::LogMan::INSTANCE();
+  auto const mode = man.mode();
+  std::size_t evaluated = 0;
+  auto const count = [&]() { return ++evaluated; };
+  std::string out;
+  man.setOut([&](std::string const& s) { out += s; });
+
+  man.setMode(mkn::kul::log::mode::INF);
+  KLOG(ERR) << count();
+  KOUT(ERR) << count();
+  EXPECT_EQ(evaluated, 0u);
+  EXPECT_TRUE(out.empty());
+  KLOG(INF) << count();
+  KOUT(INF) << count();
+  EXPECT_EQ(evaluated, 2u);
+  EXPECT_NE(out.find("1"), std::string::npos);
+
+  man.setMode(mkn::kul::log::mode::OFF);
+  if (evaluated)
+    KLOG(NON) << count();  // the expansion must not capture the else
+  else
+    FAIL();
+  EXPECT_EQ(evaluated, 2u);
+
+  man.setOut(nullptr);
+  man.setMode(mode);
+}
+
+TEST(LogLevels, messagesMatchStream) {
+  auto& man = mkn::kul::LogMan::INSTANCE();
+  auto const mode = man.mode();
+  std::string out;
+  man.setOut([&](std::string const& s) { out += s; });
+  man.setMode(mkn::kul::log::mode::INF);
+
+  std::ostringstream ss;
+  ss.precision(22);
+  ss << "a " << 1 << ' ' << 0.1f << ' ' << 1e300 << ' ' << false << std::hex << 255 << " " << 2.5;
+  KOUT(INF) << "a " << 1 << ' ' << 0.1f << ' ' << 1e300 << ' ' << false << std::hex << 255 << " "
+            << 2.5;
+  EXPECT_EQ(ss.str() + mkn::kul::os::EOL(), out);
+
+  man.setOut(nullptr);
+  man.setMode(mode);
+}
+
+TEST(FileSink, batchesAndRotates) {
+  std::string const path = "mkn.kul.filesink.log";
+  std::vector<std::string> rotated;
+  std::mutex m;
+  {
+    mkn::kul::log::FileSink::Config c;
+    c.max_bytes = 64;
+    c.keep = 2;
+    c.on_rotate = [&](std::string const& f) {
+      std::lock_guard<std::mutex> l(m);
+      rotated.emplace_back(f);
+      return f;
+    };
+    mkn::kul::log::FileSink sink(path, c);
+    std::function<void(std::string const&)> out = std::ref(sink);
+    for (std::size_t i = 0; i < 30; ++i) out("line " + std::to_string(i) + "\n");
+    sink.flush();
+  }
+  auto const read = [](std::string const& f) {
+    std::string s;
+    if (auto* fp = std::fopen(f.c_str(), "rb")) {
+      char b[256];
+      for (std::size_t n; (n = std::fread(b, 1, sizeof(b), fp));) s.append(b, n);
+      std::fclose(fp);
+    }
+    return s;
+  };
+  ASSERT_EQ(rotated.size(), 3u);  // 230 bytes of whole lines, at most 64 per file
+  for (std::size_t i = 0; i < rotated.size(); ++i)
+    EXPECT_EQ(mkn::kul::File(rotated[i]).is(), i > 0);  // keep = 2
+  std::string all;
+  for (std::size_t i = 1; i < rotated.size(); ++i) {
+    auto const s = read(rotated[i]);
+    EXPECT_LE(s.size(), 64u);
+    EXPECT_EQ(s.back(), '\n');
+    all += s;
+    std::remove(rotated[i].c_str());
+  }
+  all += read(path);
+  std::remove(path.c_str());
+  EXPECT_EQ(all.find("line 9\n"), 0u);
+  EXPECT_EQ(all.size(), 7u + 20 * 8);
+}
+
+TEST(FileSink, survivesLosingItsDirectory) {
+  mkn::kul::Dir const dir("mkn.kul.filesink.dir");
+  dir.mk();
+  std::string const path = dir.join("log");
+  mkn::kul::log::FileSink::Config c;
+  c.max_bytes = 16;
+  mkn::kul::log::FileSink sink(path, c);
+  sink.append("first line\n");
+  sink.flush();
+  std::remove(path.c_str());
+  dir.rm();  // rotating can neither rename nor reopen the file now
+  for (std::size_t i = 0; i < 4; ++i) sink.append("line " + std::to_string(i) + "\n");
+  sink.flush();
+  EXPECT_EQ(sink.dropped(), 4u);
+}
+
+TEST(LogKV, encodesTypedFields) {
+  auto& man = mkn::kul::LogMan::INSTANCE();
+  auto const mode = man.mode();
+  std::string out;
+  man.setOut([&](std::string const& s) { out += s; });
+  man.setMode(mkn::kul::log::mode::INF);
+
+  std::string const path = "a\"b\n";
+  KLOG_KV(INF, "req", 42, "lat_us", 1.5, "ok", true, "path", path, "lit", "x", "none", nullptr);
+  KLOG_KV(DBG, "filtered", 1);
+  EXPECT_EQ(out.find("{\"ts\":"), 0u);
+  EXPECT_NE(out.find("\"level\":\"INF\""), std::string::npos);
+  EXPECT_NE(out.find(",\"req\":42,\"lat_us\":1.5,\"ok\":true,\"path\":\"a\\\"b\\n\",\"lit\":\"x\","
+                     "\"none\":null}"),
+            std::string::npos);
+  EXPECT_EQ(out.find("filtered"), std::string::npos);
+
+  out.clear();
+  man.setKV(mkn::kul::log::kv::Encoding::BINARY);
+  KLOG_KV(INF, "n", std::uint64_t{7});
+  man.setKV(mkn::kul::log::kv::Encoding::JSON);
+  std::uint32_t n = 0;
+  ASSERT_GT(out.size(), sizeof(n));
+  std::memcpy(&n, out.data(), sizeof(n));
+  EXPECT_EQ(n + sizeof(n), out.size());
+  std::uint64_t v = 0;
+  std::memcpy(&v, out.data() + out.size() - sizeof(v), sizeof(v));
+  EXPECT_EQ(v, 7u);
+  EXPECT_EQ(out[out.size() - sizeof(v) - 1], char(mkn::kul::log::kv::Type::UINT));
+
+  mkn::kul::log::kv::Field copied;
+  {
+    mkn::kul::log::kv::Field f;
+    f.value.set(std::complex<double>(1.5e300, -2.5e-300));
+    copied = f;
+  }
+  EXPECT_EQ(copied.value.s, "(1.5e+300,-2.5e-300)");
+  mkn::kul::log::kv::Value const moved(std::move(copied.value));
+  EXPECT_EQ(moved.s, "(1.5e+300,-2.5e-300)");
+
+  std::size_t seen = 0;
+  man.setKV([&](mkn::kul::log::kv::Record const& r) {
+    seen = r.size;
+    EXPECT_EQ(r.fields[0].key, "k");
+    EXPECT_EQ(r.fields[0].value.i, -3);
+  });
+  KLOG_KV(INF, "k", -3);
+  man.setKV(nullptr);
+  EXPECT_EQ(seen, 1u);
+
+  man.setOut(nullptr);
+  man.setMode(mode);
+}
+
+TEST(LogThrottle, limitsPerCallSite) {
+  auto& man = mkn::kul::LogMan::INSTANCE();
+  auto const mode = man.mode();
+  std::vector<std::string> out;
+  man.setOut([&](std::string const& s) { out.emplace_back(s); });
+  man.setMode(mkn::kul::log::mode::INF);
+  auto const count = [&](std::string const& s) {
+    return std::count_if(out.begin(), out.end(),
+                         [&](auto const& o) { return o.find(s) != std::string::npos; });
+  };
+
+  for (std::size_t i = 0; i < 10; ++i) KLOG_EVERY_N(INF, 4) << "every " << i;
+  EXPECT_EQ(count("every "), 3);  // 0, 4, 8
+  EXPECT_EQ(count("every 8"), 1);
+
+  for (std::size_t i = 0; i < 10; ++i) KLOG_EVERY_MS(INF, 60000) << "ms " << i;
+  EXPECT_EQ(count("ms "), 1);
+
+  for (std::size_t i = 0; i < 10; ++i) KLOG_RATE(INF, 3) << "rate " << i;
+  EXPECT_EQ(count("rate "), 3);  // the initial burst
+
+  std::size_t evaluated = 0;
+  auto const inc = [&]() { return ++evaluated; };
+  for (std::size_t i = 0; i < 10; ++i) KLOG_RATE(INF, 0.5) << inc();
+  EXPECT_EQ(evaluated, 1u);
+
+  out.clear();
+  auto const rate = [&]() { KLOG_RATE(INF, 1e6) << "burst"; };
+  for (std::size_t i = 0; i < 3; ++i) rate();
+  EXPECT_EQ(count("burst"), 3);
+  EXPECT_EQ(count("suppressed"), 0);
+
+  out.clear();
+  auto const tick = [&](std::size_t const i) { KLOG_EVERY_MS(INF, 20) << "tick " << i; };
+  for (std::size_t i = 0; i < 3; ++i) tick(i);
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  tick(3);
+  ASSERT_EQ(out.size(), 3u);
+  EXPECT_NE(out[1].find("suppressed 2 messages"), std::string::npos);
+  EXPECT_NE(out[2].find("tick 3"), std::string::npos);
+
+  man.setOut(nullptr);
+  man.setMode(mode);
+}
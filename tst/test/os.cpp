@@ -2,8 +2,10 @@
 
 #include "test_common.hpp"
 
+#include "mkn/kul/io.hpp"
 #include "mkn/kul/os.hpp"
 #include "mkn/kul/proc.hpp"
+#include "mkn/kul/os/cp.hpp"
 
 TEST(OperatingSystemTests, HasRAMUsageSupport) {
   ASSERT_TRUE(mkn::kul::this_proc::physicalMemory());
@@ -96,3 +98,32 @@ TEST(OperatingSystemTests, FileBareNonExistentNameDefaultsToCWD) {
   EXPECT_FALSE(f.is());
   EXPECT_EQ(mkn::kul::Dir(mkn::kul::env::CWD()).real(), f.dir().real());
 }
+
+TEST(OperatingSystemTests, DirCopiesTreeInParallel) {
+  mkn::kul::Dir const src("mkn.kul.cp.src"), dst("mkn.kul.cp.dst");
+  src.rm(), dst.rm();
+  mkn::kul::Dir const sub(src.join("sub"), true);
+  for (std::size_t i = 0; i < 32; ++i) {
+    auto const& d = i % 2 ? src : sub;
+    mkn::kul::io::Writer(mkn::kul::File(std::to_string(i), d))
+        << std::string(i * 1000, static_cast<char>('a' + i % 26));
+  }
+  mkn::kul::File empty("empty", src);
+  empty.mk();
+  mkn::kul::Dir const out(dst.join(src.name()));
+  auto const check = [&]() {
+    for (std::size_t i = 0; i < 32; ++i) {
+      mkn::kul::File const f(std::to_string(i), i % 2 ? out : mkn::kul::Dir(out.join("sub")));
+      ASSERT_TRUE(f.is());
+      EXPECT_EQ(f.size(), i * 1000);
+    }
+    EXPECT_TRUE(mkn::kul::File("empty", out).is());
+  };
+  ASSERT_TRUE(mkn::kul::parallel_cp(src, dst));
+  check();
+  dst.rm();
+  ASSERT_TRUE(src.cp(dst));
+  check();
+  EXPECT_FALSE(mkn::kul::File("missing", src).cp(mkn::kul::File("missing", out)));
+  src.rm(), dst.rm();
+}
@@ -3,6 +3,7 @@
 #include "test_common.hpp"
 
 #include "mkn/kul/span.hpp"
+#include "mkn/kul/parallel.hpp"
 
 TEST(Span, init) {
   {
@@ -30,3 +31,36 @@ TEST(SpanSet, containsCorrectData) {
   for (auto const& span : spanset)
     for (auto const& d0 : span) EXPECT_EQ(d0, vals[i++]);
 }
+
+TEST(Span, parallel) {
+  std::vector<double> v(100000);
+  std::iota(v.begin(), v.end(), 0);
+  mkn::kul::Span<double> span{v};
+  mkn::kul::parallel_for(span, [](double& d) { d *= 2; });
+  for (std::size_t i = 0; i < v.size(); i++) EXPECT_EQ(v[i], static_cast<double>(i) * 2.0);
+
+  auto const sum = mkn::kul::parallel_reduce(span, 0.0, std::plus<>{}, 1000);
+  EXPECT_EQ(sum, std::accumulate(v.begin(), v.end(), 0.0));
+
+  auto const big = mkn::kul::parallel_reduce(
+      mkn::kul::parallel::pool(), span, std::size_t{0},
+      [](std::size_t const n, double const d) { return n + (d > 5); }, std::plus<>{}, 1000);
+  EXPECT_EQ(big, v.size() - 3);  // 0, 2 and 4 are not
+
+  auto const bounds = mkn::kul::parallel::chunks(v.data() + 1, v.size() - 1, 100, 4);
+  for (std::size_t b = 1; b < bounds.size() - 1; b++)
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v.data() + 1 + bounds[b]) % MKN_KUL_CACHE_LINE_SIZE,
+              0u);
+
+  EXPECT_THROW(mkn::kul::parallel_for(span, [](double&) { KEXCEPTION("Exceptional!"); }),
+               mkn::kul::Exception);
+}
+
+TEST(SpanSet, parallel) {
+  mkn::kul::SpanSet<double> spanset{std::vector<size_t>{2, 3, 4}};
+  mkn::kul::parallel_for(spanset, [](mkn::kul::Span<double> span) {
+    for (auto& d : span) d = static_cast<double>(span.size());
+  });
+  for (std::size_t i = 0; i < 3; i++)
+    for (auto const& d : spanset[i]) EXPECT_EQ(d, static_cast<double>(spanset.sizes()[i]));
+}
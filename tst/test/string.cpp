@@ -214,3 +214,145 @@ TEST(StringOperations, String_2_Int64_t_valid) {
        []() { mkn::kul::String::INT64(std::to_string((std::numeric_limits<int64_t>::max)())); }},
       false);
 }
+
+TEST(StringOperations, SplitViewsPointIntoInput) {
+  std::string const s = "a,,b\\,c,\r\nd\r\n\nlast";
+  std::vector<std::string_view> v;
+  mkn::kul::split_view(s, ',').into(v);
+  ASSERT_EQ((size_t)4, v.size());
+  EXPECT_EQ("b\\", v[1]);
+  EXPECT_EQ(s.data() + 3, v[1].data());
+  v.clear();
+  mkn::kul::split_view(s, ',', true).into(v);
+  EXPECT_EQ((size_t)5, v.size());
+  EXPECT_EQ("", v[1]);
+
+  std::vector<std::string_view> e;
+  for (auto const p : mkn::kul::esc_split_view(s, ',')) e.emplace_back(p);
+  ASSERT_EQ((size_t)4, e.size());
+  EXPECT_EQ("b\\,c", e[2]);
+
+  std::vector<std::string_view> const l(mkn::kul::lines_view(s).begin(),
+                                        mkn::kul::lines_view(s).end());
+  ASSERT_EQ((size_t)3, l.size());
+  EXPECT_EQ("a,,b\\,c,", l[0]);
+  EXPECT_EQ("d", l[1]);
+  EXPECT_EQ("last", l[2]);
+
+  v.clear();
+  mkn::kul::split_view("a--b--", "--").into(v);
+  EXPECT_EQ((std::vector<std::string_view>{"a", "b"}), v);
+  v.clear();
+  mkn::kul::split_view("a,b", "", true).into(v);
+  EXPECT_EQ((std::vector<std::string_view>{"a,b"}), v);
+  v.clear();
+  mkn::kul::split_view("", "", true).into(v);
+  EXPECT_EQ((std::vector<std::string_view>{""}), v);
+  auto const empty = mkn::kul::split_view("", ',');
+  EXPECT_TRUE(empty.begin() == empty.end());
+}
+
+TEST(StringOperations, ReplaceAllAndMany) {
+  std::string s = "a.b..c.";
+  mkn::kul::String::REPLACE_ALL(s, ".", "::");
+  EXPECT_EQ("a::b::::c::", s);
+  mkn::kul::String::REPLACE_ALL(s, "::", ":");
+  EXPECT_EQ("a:b::c:", s);
+  mkn::kul::String::REPLACE_ALL(s, ":", "");
+  EXPECT_EQ("abc", s);
+  mkn::kul::String::REPLACE_ALL(s, "", "x");
+  EXPECT_EQ("abc", s);
+
+  s = "<a href=\"x&y\">&lt;</a>";
+  mkn::kul::String::REPLACE_MANY(s, {{"&", "&amp;"}, {"<", "&lt;"}, {">", "&gt;"}, {"\"", ""}});
+  EXPECT_EQ("&lt;a href=x&amp;y&gt;&amp;lt;&lt;/a&gt;", s);
+  s = "aaab";
+  mkn::kul::String::REPLACE_MANY(s, {{"a", "1"}, {"aa", "2"}, {"ab", "3"}});
+  EXPECT_EQ("23", s);
+}
+
+TEST(StringOperations, ParseNumbersWithoutThrowing) {
+  using mkn::kul::parse;
+  EXPECT_EQ(1234567890123456789u, *parse<uint64_t>("1234567890123456789"));
+  EXPECT_EQ(18446744073709551615u, *parse<uint64_t>("18446744073709551615"));
+  EXPECT_EQ(mkn::kul::IS_OVERFLOW, parse<uint64_t>("18446744073709551616").ret);
+  EXPECT_EQ(12u, *parse<uint64_t>("0000000000000000000000012"));
+  EXPECT_EQ(INT64_MIN, *parse<int64_t>("-9223372036854775808"));
+  EXPECT_EQ(mkn::kul::IS_UNDERFLOW, parse<int64_t>("-9223372036854775809").ret);
+  EXPECT_EQ(-32768, *parse<int16_t>("-32768"));
+  EXPECT_EQ(mkn::kul::IS_OVERFLOW, parse<int16_t>("32768").ret);
+  EXPECT_EQ(mkn::kul::IS_UNDERFLOW, parse<uint32_t>("-1").ret);
+  EXPECT_EQ(0u, *parse<uint32_t>("-0"));
+  for (auto const s : {"", "-", "+1", " 1", "1 ", "12345678x", "0x10"})
+    EXPECT_EQ(mkn::kul::IS_INCONVERTIBLE, parse<int32_t>(s).ret) << s;
+
+  EXPECT_DOUBLE_EQ(-1.5e-3, *parse<double>("-1.5e-3"));
+  EXPECT_FLOAT_EQ(2.25f, *parse<float>("2.25"));
+  EXPECT_EQ(mkn::kul::IS_OVERFLOW, parse<double>("1e400").ret);
+  EXPECT_EQ(mkn::kul::IS_UNDERFLOW, parse<double>("1e-400").ret);
+  EXPECT_FALSE(parse<double>("1.5x"));
+
+  EXPECT_EQ(42, mkn::kul::String::INT32(" +42"));
+  EXPECT_EQ(42u, mkn::kul::String::UINT16(std::string_view("42,43").substr(0, 2)));
+}
+
+TEST(StringOperations, AsciiKernelsMatchScalar) {
+  std::string const al = "aZ@[`{ \t\n\r\xC3\xA9-09";
+  std::uint64_t seed = 3;
+  auto rnd = [&]() { return (seed = seed * 6364136223846793005u + 1442695040888963407u) >> 33; };
+  for (std::size_t i = 0; i < 2000; ++i) {
+    std::string s;
+    for (auto n = rnd() % 70; n--;) s += al[rnd() % al.size()];
+    std::string lo = s, up = s, ref_lo = s, ref_up = s;
+    for (auto& c : ref_lo) c = (c >= 'A' && c <= 'Z') ? char(c + 32) : c;
+    for (auto& c : ref_up) c = (c >= 'a' && c <= 'z') ? char(c - 32) : c;
+    EXPECT_EQ(ref_lo, mkn::kul::ascii::lower(lo));
+    EXPECT_EQ(ref_up, mkn::kul::ascii::upper(up));
+    EXPECT_TRUE(mkn::kul::ascii::iequals(lo, up));
+    EXPECT_EQ(mkn::kul::ascii::ihash(lo), mkn::kul::ascii::ihash(up));
+    if (s.size()) {
+      auto other = lo;
+      other[rnd() % other.size()] ^= 0x01;
+      EXPECT_FALSE(mkn::kul::ascii::iequals(lo, other));
+    }
+
+    auto const b = s.find_first_not_of(" \t"), e = s.find_last_not_of(" \t");
+    EXPECT_EQ(b == std::string::npos ? "" : s.substr(b, e - b + 1), mkn::kul::ascii::trim(s));
+    auto const sb = s.find_first_not_of(" \t\n\v\f\r"), se = s.find_last_not_of(" \t\n\v\f\r");
+    EXPECT_EQ(sb == std::string::npos ? "" : s.substr(sb, se - sb + 1),
+              mkn::kul::ascii::trim(s, true));
+  }
+  std::string t = "  \t trim me\t ";
+  mkn::kul::String::TRIM(t);
+  EXPECT_EQ("trim me", t);
+  EXPECT_TRUE(mkn::kul::String::BOOL(" TRUE\t"));
+  EXPECT_FALSE(mkn::kul::String::BOOL("No"));
+  EXPECT_TRUE(mkn::kul::String::NO_CASE_CMP("CPP", "cpp"));
+}
+
+TEST(StringOperations, StringBuilderAppends) {
+  mkn::kul::StringBuilder<16> sb;
+  sb << "abc" << ' ' << std::string("def") << std::string_view("|") << 42 << -7 << true;
+  sb.append(0.1).append(3, '.').append(2.0 / 3, 4);
+  EXPECT_EQ("abc def|42-710.1...0.6667", sb.view());
+  EXPECT_GT(sb.capacity(), 16u);
+
+  char const* nul = nullptr;
+  sb.clear();
+  sb << nul << static_cast<unsigned char>('x') << std::uint64_t(18446744073709551615u);
+  EXPECT_EQ("x18446744073709551615", sb.str());
+
+  mkn::kul::Arena arena(64);
+  {
+    mkn::kul::StringBuilder<8> ab(arena);
+    for (std::size_t i = 0; i < 100; ++i) ab << i << ',';
+    EXPECT_EQ(0u, ab.view().find("0,1,2,"));
+    EXPECT_EQ(ab.view().substr(ab.size() - 3), "99,");
+  }
+  auto const held = arena.capacity();
+  EXPECT_GE(held, 290u);
+  arena.reset();
+  mkn::kul::StringBuilder<8> again(arena);
+  for (std::size_t i = 0; i < 100; ++i) again << i << ',';
+  EXPECT_EQ(held, arena.capacity());
+}
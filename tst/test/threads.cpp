@@ -0,0 +1,255 @@
+
+#include "test_common.hpp"
+
+#include "mkn/kul/threads.hpp"
+
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <string>
+
+TEST(WorkStealingPool, runsEveryJob) {
+  std::atomic<std::size_t> count{0};
+  mkn::kul::WorkStealingPool<> pool(4, 1);
+  for (std::size_t i = 0; i < 10000; ++i) pool.async([&]() { ++count; });
+  pool.block().finish().join();
+  EXPECT_EQ(count.load(), 10000u);
+}
+
+TEST(WorkStealingPool, runsJobsPostedFromWorkers) {
+  std::atomic<std::size_t> count{0};
+  mkn::kul::WorkStealingPool<> pool(3, 1);
+  for (std::size_t i = 0; i < 100; ++i)
+    pool.async([&]() {
+      for (std::size_t j = 0; j < 10; ++j) pool.async([&]() { ++count; });
+    });
+  pool.finish().join();
+  EXPECT_EQ(count.load(), 1000u);
+}
+
+TEST(WorkStealingPool, routesExceptions) {
+  std::atomic<std::size_t> handled{0};
+  {
+    mkn::kul::WorkStealingPool<> pool(2, 1);
+    for (std::size_t i = 0; i < 10; ++i)
+      pool.async([]() { KEXCEPTION("Exceptional!"); },
+                 [&](mkn::kul::Exception const&) { ++handled; });
+    pool.block().finish().join();
+    EXPECT_FALSE(pool.exception());
+  }
+  EXPECT_EQ(handled.load(), 10u);
+
+  mkn::kul::WorkStealingPool<> pool(2, 1);
+  pool.async([]() { KEXCEPTION("Unhandled!"); });
+  EXPECT_THROW(pool.finish(), mkn::kul::Exception);
+  pool.join();
+  EXPECT_THROW(pool.rethrow(), mkn::kul::Exception);
+}
+
+TEST(WorkStealingPool, finishStartsThePool) {
+  std::atomic<std::size_t> count{0};
+  mkn::kul::WorkStealingPool<> pool(2);
+  for (std::size_t i = 0; i < 100; ++i) pool.async([&]() { ++count; });
+  pool.finish().join();
+  EXPECT_EQ(count.load(), 100u);
+}
+
+TEST(Future, carriesResults) {
+  mkn::kul::WorkStealingPool<> pool(4, 1);
+  std::vector<mkn::kul::Future<std::size_t>> fs;
+  for (std::size_t i = 0; i < 100; ++i) fs.emplace_back(pool.submit([i]() { return i * 2; }));
+  auto all = mkn::kul::when_all(fs);
+  auto const& vals = all.get();
+  ASSERT_EQ(vals.size(), 100u);
+  for (std::size_t i = 0; i < vals.size(); ++i) EXPECT_EQ(vals[i], i * 2);
+  EXPECT_LT(mkn::kul::when_any(fs).get(), 100u);
+  pool.finish().join();
+
+  mkn::kul::Promise<std::string> p;
+  p.value(std::string(64, 'k'));
+  EXPECT_EQ(mkn::kul::when_all(std::vector{p.future()}).get()[0], std::string(64, 'k'));
+  EXPECT_EQ(p.future().get(), std::string(64, 'k'));  // inputs keep their values
+}
+
+TEST(Future, carriesExceptions) {
+  std::atomic<std::size_t> handled{0};
+  mkn::kul::ConcurrentThreadPool<> pool(2, 1);
+  auto ok = pool.submit([]() {});
+  auto bad = pool.submit([]() -> int { KEXCEPTION("Exceptional!"); },
+                         [&](mkn::kul::Exception const&) { ++handled; });
+  EXPECT_NO_THROW(ok.get());
+  EXPECT_THROW(bad.get(), mkn::kul::Exception);
+  EXPECT_THROW(mkn::kul::when_all(std::vector{bad}).get(), mkn::kul::Exception);
+  EXPECT_EQ(handled.load(), 1u);
+  pool.block().finish().join();
+  EXPECT_THROW(pool.submit([]() {}).get(), mkn::kul::threading::Exception);
+}
+
+TEST(MPMCQueue, boundedOrder) {
+  mkn::kul::MPMCQueue<std::string, 4> q;
+  EXPECT_TRUE(q.empty());
+  for (std::size_t i = 0; i < 4; ++i) EXPECT_TRUE(q.try_push(std::to_string(i)));
+  EXPECT_FALSE(q.try_push("full"));
+  EXPECT_EQ(q.size(), 4u);
+  std::string s;
+  for (std::size_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(q.try_pop(s));
+    EXPECT_EQ(s, std::to_string(i));
+  }
+  EXPECT_FALSE(q.try_pop(s));
+  EXPECT_TRUE(q.try_emplace(3, 'a'));
+  EXPECT_TRUE(q.try_pop(s));
+  EXPECT_EQ(s, "aaa");
+
+  struct NoDefault {
+    NoDefault(std::size_t const n) : s(n, 'x') {}
+    std::string s;
+  };
+  mkn::kul::MPMCQueue<NoDefault, 4> nd;  // left holding values, destroyed in place
+  EXPECT_TRUE(nd.try_emplace(std::size_t{64}));
+  EXPECT_TRUE(nd.try_emplace(std::size_t{64}));
+}
+
+TEST(MPMCQueue, manyProducersAndConsumers) {
+  constexpr std::size_t per = 20000, threads = 4;
+  mkn::kul::MPMCQueue<std::size_t, 64> q;
+  std::atomic<std::size_t> sum{0}, popped{0};
+  std::vector<std::thread> ts;
+  for (std::size_t t = 0; t < threads; ++t) {
+    ts.emplace_back([&]() {
+      for (std::size_t i = 1; i <= per; ++i) q.push(i);
+    });
+    ts.emplace_back([&]() {
+      std::size_t v;
+      while (popped.load() < per * threads)
+        if (q.try_pop(v)) {
+          sum += v;
+          ++popped;
+        } else
+          std::this_thread::yield();
+    });
+  }
+  for (auto& t : ts) t.join();
+  EXPECT_EQ(sum.load(), threads * per * (per + 1) / 2);
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(ConcurrentThreadPool, overflowsQueue) {
+  std::atomic<std::size_t> count{0};
+  mkn::kul::ConcurrentThreadPool<> pool(2, 1);
+  for (std::size_t i = 0; i < MKN_KUL_THREAD_QUEUE_SIZE + 100; ++i) pool.async([&]() { ++count; });
+  pool.block().finish(1000).join();
+  EXPECT_EQ(count.load(), MKN_KUL_THREAD_QUEUE_SIZE + 100u);
+
+  std::vector<std::size_t> order;  // one job at a time, so they run in the order served
+  mkn::kul::ConcurrentThreadQueue<void()> q(1, 0, 1000);
+  for (std::size_t i = 0; i < MKN_KUL_THREAD_QUEUE_SIZE + 100; ++i)
+    q.async([&order, i]() { order.emplace_back(i); });
+  q.start().finish(1000).join();
+  ASSERT_EQ(order.size(), MKN_KUL_THREAD_QUEUE_SIZE + 100u);
+  EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+}
+
+template <typename M>
+void lock_counts() {
+  M m;
+  std::size_t count = 0;
+  std::vector<std::thread> ts;
+  for (std::size_t t = 0; t < 4; ++t)
+    ts.emplace_back([&]() {
+      for (std::size_t i = 0; i < 10000; ++i) {
+        mkn::kul::ScopeLock l(m);
+        ++count;
+      }
+    });
+  for (auto& t : ts) t.join();
+  EXPECT_EQ(count, 40000u);
+  EXPECT_TRUE(m.tryLock());
+  m.unlock();
+}
+
+TEST(Locks, exclude) {
+  lock_counts<mkn::kul::Mutex>();
+  lock_counts<mkn::kul::PlainMutex>();
+  lock_counts<mkn::kul::AdaptiveMutex>();
+  lock_counts<mkn::kul::TicketLock>();
+  lock_counts<mkn::kul::RWLock>();
+}
+
+TEST(Locks, readersShare) {
+  mkn::kul::RWLock rw;
+  {
+    mkn::kul::SharedScopeLock r0(rw);
+    EXPECT_TRUE(rw.tryLockShared());
+    EXPECT_FALSE(rw.tryLock());
+    rw.unlockShared();
+  }
+  mkn::kul::ScopeLock w(rw);
+  EXPECT_FALSE(rw.tryLockShared());
+}
+
+TEST(CPU, topology) {
+  auto const ids = mkn::kul::cpu::Topology::parse("0-3,8,10-11");
+  EXPECT_EQ(ids, (std::vector<std::uint32_t>{0, 1, 2, 3, 8, 10, 11}));
+
+  auto const& topo = mkn::kul::cpu::topology();
+  ASSERT_FALSE(topo.processors().empty());
+  EXPECT_LE(topo.cores(), topo.processors().size());
+  EXPECT_GE(topo.sockets(), 1u);
+  EXPECT_GE(topo.nodes(), 1u);
+  auto const first = topo.processors()[0].id;
+  auto const l3 = topo.sharing(first, 3);
+  EXPECT_NE(std::find(l3.begin(), l3.end(), first), l3.end());
+}
+
+TEST(WorkStealingPool, pinsWorkerLocals) {
+  mkn::kul::WorkStealingPool<> pool(2);
+  mkn::kul::WorkerLocal<std::vector<std::size_t>> locals(pool, 16);
+  pool.pin().start();
+  EXPECT_THROW(pool.pin(), mkn::kul::Exception);
+  std::atomic<std::size_t> count{0};
+  for (std::size_t i = 0; i < 100; ++i)
+    pool.async([&]() {
+      locals.local()[0]++;
+      ++count;
+    });
+  pool.finish().join();
+  pool.rethrow();
+  EXPECT_EQ(count.load(), 100u);
+  EXPECT_EQ(locals[0][0] + locals[1][0], 100u);
+  EXPECT_EQ(pool.worker(), pool.size());
+}
+
+TEST(Thread, runsUnpinnedOutsideCpuset) {
+  std::atomic<bool> ran{false};
+  mkn::kul::Thread th([&]() { ran = true; });
+  th.affinity({1023});  // past any cpuset here, the pin is refused
+  th.run();
+  th.join();
+  EXPECT_TRUE(ran.load());
+}
+
+TEST(SPSCRing, wrapsVariableRecords) {
+  mkn::kul::SPSCRing<256> ring;
+  std::size_t pushed = 0, popped = 0, bytes = 0;
+  std::thread consumer([&]() {
+    while (popped < 1000)
+      popped += ring.drain([&](unsigned char const* b, std::size_t n) {
+        EXPECT_EQ(n, std::size_t(b[0]));
+        EXPECT_EQ(n, std::size_t(b[n - 1]));
+        bytes += n;
+      });
+  });
+  for (; pushed < 1000; ++pushed) {
+    auto const n = pushed % 40 + 1;
+    unsigned char* b = nullptr;
+    while (!(b = ring.reserve(n))) std::this_thread::yield();
+    std::memset(b, static_cast<int>(n), n);
+    ring.commit(n);
+  }
+  consumer.join();
+  EXPECT_TRUE(ring.empty());
+  EXPECT_EQ(ring.reserve(256), nullptr);
+}